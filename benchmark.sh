@@ -0,0 +1,187 @@
+#!/usr/bin/env bash
+
+# Weak and strong scaling runs of one cloverleaf build, with generated decks.
+#
+# Weak scaling keeps --cells cells per rank, strong scaling keeps --cells cells in total, both as a square grid of the
+# bm decks' problem (InputDecks/clover_bm*.in). Every rank count in --ranks is run with every thread count in --threads
+# and the results go into results.csv, with the wall clock, time per cell, steady state step time per cell (the mean
+# over the steps after the warmup), scaling efficiency and the profiler breakdown. The efficiency is against the first
+# (smallest) configuration: t_1 / t_n for weak scaling, t_1 * p_1 / (t_n * p_n) for strong scaling, where p is ranks x
+# threads.
+#
+# Usage: benchmark.sh --exe <BIN> [options], see --help. Also available as `cmake --build <dir> --target benchmark`,
+# which passes BENCHMARK_ARGS through and runs in <dir>/benchmark.
+
+set -eu
+
+EXE=""
+MODE="weak"
+CELLS=""
+RANK_LIST="1,2,4"
+THREAD_LIST="1"
+STEPS=20
+MPI="on"
+LAUNCHER="mpirun -np"
+OUT="results.csv"
+BASELINE=""
+SAVE_BASELINE=""
+EXTRA_ARGS=()
+
+function usage() {
+  cat <<EOF
+Usage: $0 --exe <BIN> [OPTIONS] [-- <extra cloverleaf args>]
+
+Options:
+  --exe            <BIN>     The cloverleaf executable to run
+  --mode    <weak|strong>    Weak or strong scaling, defaults to weak
+  --cells            <N>     Cells per rank (weak) or in total (strong), defaults to 1920^2 or 3840^2
+  --ranks       <N,N,...>    Rank counts to run, defaults to 1,2,4
+  --threads     <N,N,...>    OMP_NUM_THREADS values to run, defaults to 1
+  --steps            <N>     Steps per run, defaults to 20
+  --mpi        <on|off>      Whether the build has MPI, off runs the ranks as threads with --ranks, defaults to on
+  --launcher       <CMD>     Launcher taking the rank count as its last argument, defaults to "mpirun -np"
+  --out           <FILE>     Results table, defaults to results.csv
+  --baseline      <FILE>     Compare the wall clock against an earlier results table
+  --save-baseline <FILE>     Copy the results table to FILE afterwards
+EOF
+}
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+  --exe) EXE="$2"; shift 2 ;;
+  --mode) MODE="$2"; shift 2 ;;
+  --cells) CELLS="$2"; shift 2 ;;
+  --ranks) RANK_LIST="$2"; shift 2 ;;
+  --threads) THREAD_LIST="$2"; shift 2 ;;
+  --steps) STEPS="$2"; shift 2 ;;
+  --mpi) MPI="$2"; shift 2 ;;
+  --launcher) LAUNCHER="$2"; shift 2 ;;
+  --out) OUT="$2"; shift 2 ;;
+  --baseline) BASELINE="$2"; shift 2 ;;
+  --save-baseline) SAVE_BASELINE="$2"; shift 2 ;;
+  -h | --help) usage; exit 0 ;;
+  --) shift; EXTRA_ARGS=("$@"); break ;;
+  *) echo "Unknown argument: $1" >&2; usage; exit 1 ;;
+  esac
+done
+
+if [[ -z "$EXE" || ! -x "$EXE" ]]; then
+  echo "--exe must name a cloverleaf executable, got \`$EXE\`" >&2
+  exit 1
+fi
+if [[ "$MODE" != "weak" && "$MODE" != "strong" ]]; then
+  echo "Illegal --mode option: $MODE" >&2
+  exit 1
+fi
+if [[ -z "$CELLS" ]]; then
+  if [[ "$MODE" == "weak" ]]; then CELLS=$((1920 * 1920)); else CELLS=$((3840 * 3840)); fi
+fi
+
+PROFILE_KEYS=("Timestep" "Ideal Gas" "Viscosity" "PdV" "Revert" "Acceleration" "Fluxes" "Cell Advection"
+  "Momentum Advection" "Reset" "Summary" "Visit" "Tile Halo Exchange" "Self Halo Exchange" "MPI Halo Exchange")
+
+# Same problem as the bm decks on a square grid of at least the given number of cells
+function write_deck() {
+  local n
+  n=$(awk -v c="$2" 'BEGIN { n = int(sqrt(c)); if (n * n < c) n++; print n }')
+  cat >"$1" <<EOF
+*clover
+
+ state 1 density=0.2 energy=1.0
+ state 2 density=1.0 energy=2.5 geometry=rectangle xmin=0.0 xmax=5.0 ymin=0.0 ymax=2.0
+
+ x_cells=$n
+ y_cells=$n
+
+ xmin=0.0
+ ymin=0.0
+ xmax=10.0
+ ymax=10.0
+
+ initial_timestep=0.04
+ timestep_rise=1.5
+ max_timestep=0.04
+ end_time=1000.0
+ end_step=$STEPS
+ summary_frequency=$STEPS
+ profiler_on
+*endclover
+EOF
+  echo "$n"
+}
+
+# Last value of a "Key  value" line in the run's stdout
+function last_value() {
+  grep -E "^ *$2 " "$1" | tail -n 1 | awk '{ print $NF }'
+}
+
+# Seconds spent in a profiler section, from lines like " PdV                   :0.058765 4.072801"
+function profile_value() {
+  grep -E "^ *$2 *:" "$1" | tail -n 1 | sed -E 's/^[^:]*:([^ ]+).*/\1/'
+}
+
+mkdir -p decks logs
+header="mode,ranks,threads,x_cells,y_cells,wall,time_per_cell,steady_time_per_cell,efficiency"
+for key in "${PROFILE_KEYS[@]}"; do header="$header,${key// /_}"; done
+echo "$header" >"$OUT"
+
+IFS=',' read -r -a ranks_list <<<"$RANK_LIST"
+IFS=',' read -r -a threads_list <<<"$THREAD_LIST"
+
+first_wall=""
+first_workers=""
+for ranks in "${ranks_list[@]}"; do
+  for threads in "${threads_list[@]}"; do
+    if [[ "$MODE" == "weak" ]]; then total=$((CELLS * ranks)); else total=$CELLS; fi
+    name="${MODE}_r${ranks}_t${threads}"
+    deck="decks/$name.in"
+    n=$(write_deck "$deck" "$total")
+    log="logs/$name.log"
+
+    echo "# $name: ${n}x${n} cells on $ranks rank(s) x $threads thread(s)"
+    status=0
+    if [[ "$MPI" == "on" ]]; then
+      # shellcheck disable=SC2086
+      OMP_NUM_THREADS=$threads $LAUNCHER "$ranks" "$EXE" --file "$deck" --out "logs/$name.out" ${EXTRA_ARGS[@]+"${EXTRA_ARGS[@]}"} >"$log" 2>&1 || status=$?
+    else
+      OMP_NUM_THREADS=$threads "$EXE" --ranks "$ranks" --file "$deck" --out "logs/$name.out" ${EXTRA_ARGS[@]+"${EXTRA_ARGS[@]}"} >"$log" 2>&1 || status=$?
+    fi
+    if [[ $status -ne 0 ]]; then
+      echo "# $name failed with exit code $status, see $log"
+      continue
+    fi
+
+    wall=$(last_value "$log" "Wall clock")
+    per_cell=$(last_value "$log" "Average time per cell")
+    steady_per_cell=$(last_value "$log" "Steady time per cell")
+    workers=$((ranks * threads))
+    if [[ -z "$first_wall" ]]; then
+      first_wall=$wall
+      first_workers=$workers
+    fi
+    efficiency=$(awk -v m="$MODE" -v t1="$first_wall" -v p1="$first_workers" -v t="$wall" -v p="$workers" \
+      'BEGIN { if (m == "weak") printf "%.3f", t1 / t; else printf "%.3f", (t1 * p1) / (t * p) }')
+
+    row="$MODE,$ranks,$threads,$n,$n,$wall,${per_cell:-},${steady_per_cell:-},$efficiency"
+    for key in "${PROFILE_KEYS[@]}"; do row="$row,$(profile_value "$log" "$key")"; done
+    echo "$row" >>"$OUT"
+  done
+done
+
+echo
+awk -F, '{ printf "%-8s %6s %8s %8s %8s %12s %14s %20s %10s\n", $1, $2, $3, $4, $5, $6, $7, $8, $9 }' "$OUT"
+
+if [[ -n "$BASELINE" ]]; then
+  echo
+  echo "# Against $BASELINE (speedup > 1 is faster than the baseline)"
+  awk -F, 'NR == FNR { if (FNR > 1) base[$1 "," $2 "," $3 "," $4] = $6; next }
+           FNR == 1 { printf "%-8s %6s %8s %8s %12s %12s %8s\n", "mode", "ranks", "threads", "cells", "baseline", "wall", "speedup"; next }
+           { key = $1 "," $2 "," $3 "," $4
+             if (key in base) printf "%-8s %6s %8s %8s %12s %12s %8.3f\n", $1, $2, $3, $4, base[key], $6, base[key] / $6
+             else printf "%-8s %6s %8s %8s %12s %12s %8s\n", $1, $2, $3, $4, "-", $6, "-" }' "$BASELINE" "$OUT"
+fi
+
+if [[ -n "$SAVE_BASELINE" ]]; then
+  cp "$OUT" "$SAVE_BASELINE"
+  echo "# Saved baseline to $SAVE_BASELINE"
+fi
@@ -22,3 +22,6 @@
 #include "definitions.h"
 
 void advec_cell_driver(global_variables &globals, int tile, int sweep_number, int direction);
+
+// Whether this model has the simd variant of the cell and momentum flux loops
+bool advec_simd_supported();
@@ -20,7 +20,9 @@
 #include "advection.h"
 #include "advec_cell.h"
 #include "advec_mom.h"
+#include "perf_counters.h"
 #include "timer.h"
+#include "trace.h"
 #include "update_halo.h"
 
 //  @brief Top level advection driver
@@ -47,10 +49,14 @@ void advection(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::advec_cell);
+  clover::trace::begin("advec_cell");
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
     advec_cell_driver(globals, tile, sweep_number, direction);
   }
+  clover::trace::end();
 
+  clover::counters::end(clover::counters::advec_cell);
   if (globals.profiler_on) globals.profiler.cell_advection += timer() - kernel_time;
 
   for (int &field : fields)
@@ -64,12 +70,16 @@ void advection(global_variables &globals) {
   update_halo(globals, fields, 2);
 
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::advec_mom);
 
+  clover::trace::begin("advec_mom");
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
     advec_mom_driver(globals, tile, xvel, direction, sweep_number);
     advec_mom_driver(globals, tile, yvel, direction, sweep_number);
   }
+  clover::trace::end();
 
+  clover::counters::end(clover::counters::advec_mom);
   if (globals.profiler_on) globals.profiler.mom_advection += timer() - kernel_time;
 
   sweep_number = 2;
@@ -77,11 +87,15 @@ void advection(global_variables &globals) {
   if (!globals.advect_x) direction = g_xdir;
 
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::advec_cell);
 
+  clover::trace::begin("advec_cell");
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
     advec_cell_driver(globals, tile, sweep_number, direction);
   }
+  clover::trace::end();
 
+  clover::counters::end(clover::counters::advec_cell);
   if (globals.profiler_on) globals.profiler.cell_advection += timer() - kernel_time;
 
   for (int &field : fields)
@@ -95,11 +109,15 @@ void advection(global_variables &globals) {
   update_halo(globals, fields, 2);
 
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::advec_mom);
 
+  clover::trace::begin("advec_mom");
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
     advec_mom_driver(globals, tile, xvel, direction, sweep_number);
     advec_mom_driver(globals, tile, yvel, direction, sweep_number);
   }
+  clover::trace::end();
 
+  clover::counters::end(clover::counters::advec_mom);
   if (globals.profiler_on) globals.profiler.mom_advection += timer() - kernel_time;
 }
@@ -0,0 +1,155 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "arena.h"
+
+#include "huge_pages.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace clover::arena {
+
+static constexpr size_t alignment = 64;
+
+// The array whose slot each work array shares under the aliased layout, see arena.h
+static constexpr std::array<std::pair<array, array>, 7> aliases{{{work_array1, soundspeed},
+                                                                 {work_array2, pressure},
+                                                                 {work_array3, viscosity},
+                                                                 {work_array4, density0},
+                                                                 {work_array5, energy0},
+                                                                 {work_array6, xvel0},
+                                                                 {work_array7, yvel0}}};
+
+std::array<size_t, arrays> extents(size_t xrange, size_t yrange) {
+  const size_t cells = xrange * yrange, nodes = (xrange + 1) * (yrange + 1);
+  const size_t x_faces = (xrange + 1) * yrange, y_faces = xrange * (yrange + 1);
+  std::array<size_t, arrays> n{};
+  for (array a : {density0, density1, energy0, energy1, pressure, viscosity, soundspeed, volume})
+    n[a] = cells;
+  for (array a : {xvel0, xvel1, yvel0, yvel1, work_array1, work_array2, work_array3, work_array4, work_array5, work_array6, work_array7})
+    n[a] = nodes;
+  for (array a : {vol_flux_x, mass_flux_x, xarea})
+    n[a] = x_faces;
+  for (array a : {vol_flux_y, mass_flux_y, yarea})
+    n[a] = y_faces;
+  n[cellx] = n[celldx] = xrange;
+  n[celly] = n[celldy] = yrange;
+  n[vertexx] = n[vertexdx] = xrange + 1;
+  n[vertexy] = n[vertexdy] = yrange + 1;
+  return n;
+}
+
+// The slot of each array, an array taking its own index unless it shares another's
+static std::array<int, arrays> slots(arena_type layout) {
+  std::array<int, arrays> slot{};
+  for (int a = 0; a < arrays; ++a)
+    slot[a] = a;
+  if (layout == arena_type::aliased)
+    for (auto [work, host] : aliases)
+      slot[work] = host;
+  return slot;
+}
+
+static size_t aligned(size_t bytes) { return (bytes + alignment - 1) / alignment * alignment; }
+
+// Bytes of each slot, 0 for the slots no array owns
+static std::array<size_t, arrays> slot_bytes(arena_type layout, size_t xrange, size_t yrange) {
+  auto n = extents(xrange, yrange);
+  auto slot = slots(layout);
+  std::array<size_t, arrays> bytes{};
+  for (int a = 0; a < arrays; ++a)
+    bytes[slot[a]] = std::max(bytes[slot[a]], aligned(n[a] * sizeof(double)));
+  return bytes;
+}
+
+size_t footprint(arena_type layout, size_t xrange, size_t yrange) {
+  size_t total = 0;
+  if (layout == arena_type::off) {
+    for (size_t n : extents(xrange, yrange))
+      total += n * sizeof(double);
+    return total;
+  }
+  for (size_t b : slot_bytes(layout, xrange, yrange))
+    total += b;
+  return total;
+}
+
+const char *layout_name(arena_type layout) {
+  switch (layout) {
+    case arena_type::off: return "off";
+    case arena_type::packed: return "packed";
+    case arena_type::aliased: return "aliased";
+  }
+  return "unknown";
+}
+
+block::block(arena_type layout, size_t xrange, size_t yrange) : total(0), base(nullptr) {
+  auto n = extents(xrange, yrange);
+  auto slot = slots(layout);
+  auto bytes = slot_bytes(layout, xrange, yrange);
+  std::array<size_t, arrays> start{};
+  for (int s = 0; s < arrays; ++s) {
+    start[s] = total;
+    total += bytes[s];
+  }
+  for (int a = 0; a < arrays; ++a) {
+    offset[a] = start[slot[a]];
+    capacity[a] = n[a];
+  }
+  base = static_cast<char *>(clover::pages::allocate(total));
+  if (!base) throw std::bad_alloc();
+}
+
+block::~block() { clover::pages::release(base); }
+
+double *block::carve(array a, size_t count) const {
+  if (count > capacity[a])
+    throw std::logic_error("arena: array " + std::to_string(a) + " wants " + std::to_string(count) + " doubles, the plan has " +
+                           std::to_string(capacity[a]));
+  return reinterpret_cast<double *>(base + offset[a]);
+}
+
+void report(const global_variables &globals, parallel_ &parallel, std::ostream &out) {
+  // {bytes, bytes without an arena, interior cells, tiles}
+  std::vector<double> usage(4, 0.0);
+  for (const tile_type &t : globals.chunk.tiles) {
+    const size_t xrange = (t.info.t_xmax + 2) - (t.info.t_xmin - 2) + 1;
+    const size_t yrange = (t.info.t_ymax + 2) - (t.info.t_ymin - 2) + 1;
+    usage[0] += double(footprint(globals.config.arena, xrange, yrange));
+    usage[1] += double(footprint(arena_type::off, xrange, yrange));
+    usage[2] += double(t.info.t_xmax - t.info.t_xmin + 1) * double(t.info.t_ymax - t.info.t_ymin + 1);
+    usage[3] += 1;
+  }
+  clover_sum(usage);
+  if (!parallel.boss) return;
+  std::ostringstream line;
+  line << "Field storage (arena " << layout_name(globals.config.arena) << "): " << std::fixed << std::setprecision(1)
+       << usage[0] / (1024.0 * 1024.0) << " MiB over " << std::setprecision(0) << usage[3] << " tiles, " << std::setprecision(1)
+       << usage[0] / usage[2] << " bytes per cell";
+  if (globals.config.arena != arena_type::off) line << " (" << usage[1] / usage[2] << " with an allocation per array)";
+  out << line.str() << std::endl << std::endl;
+}
+
+} // namespace clover::arena
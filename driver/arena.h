@@ -0,0 +1,120 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "comms.h"
+#include "definitions.h"
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+
+//  @brief One allocation per tile for the field arrays
+//  @details field_type used to allocate each of its 33 arrays on its own. With
+//  an arena, a tile allocates one block (through huge_pages.h, so --huge-pages
+//  covers it whole) and carves the arrays out of it at cache line aligned
+//  offsets, in the order the constructor lists them, so the fields of a tile sit
+//  next to each other. packed gives every array its own slot. aliased also puts
+//  each work array in the slot of a field that is dead while the work array is
+//  live, following the phase table in definitions.cpp:
+//    work_array1 (PdV, advection)  soundspeed  only read by calc_dt, rewritten by ideal gas first
+//    work_array2..7 (advection)    pressure, viscosity, density0, energy0, xvel0, yvel0
+//  Advection reads none of the level 0 or derived fields, reset_field rewrites
+//  the level 0 interiors after it, and the stamps of dirty.h are bumped after it
+//  (scratch_written), so the ideal gas, viscosity and halo exchanges of the next
+//  timestep run again instead of trusting overwritten data. Between steps the
+//  halo cells of the level 0 fields hold whatever advection left, and so do
+//  the pressure, soundspeed and viscosity unless a summary or visit dump
+//  refreshed them, so views of them (field_view.h) are only meaningful where
+//  the step wrote them. Only models whose buffers can take outside storage use
+//  an arena; the others keep allocating per array.
+namespace clover::arena {
+
+// The arrays of a field_type, in the order its constructor creates them
+enum array : int {
+  density0,
+  density1,
+  energy0,
+  energy1,
+  pressure,
+  viscosity,
+  soundspeed,
+  xvel0,
+  xvel1,
+  yvel0,
+  yvel1,
+  vol_flux_x,
+  mass_flux_x,
+  vol_flux_y,
+  mass_flux_y,
+  work_array1,
+  work_array2,
+  work_array3,
+  work_array4,
+  work_array5,
+  work_array6,
+  work_array7,
+  cellx,
+  celldx,
+  celly,
+  celldy,
+  vertexx,
+  vertexdx,
+  vertexy,
+  vertexdy,
+  volume,
+  xarea,
+  yarea,
+  arrays
+};
+
+// Doubles in each array of a tile of xrange by yrange cells, halos included, as field_type sizes them
+std::array<size_t, arrays> extents(size_t xrange, size_t yrange);
+
+// Bytes of field storage of such a tile under the layout, off being the sum of the arrays
+size_t footprint(arena_type layout, size_t xrange, size_t yrange);
+
+const char *layout_name(arena_type layout);
+
+class block {
+public:
+  block(arena_type layout, size_t xrange, size_t yrange);
+  ~block();
+  block(const block &) = delete;
+  block &operator=(const block &) = delete;
+
+  // Storage for the array, throws if the caller wants more doubles than extents() gave it
+  [[nodiscard]] double *carve(array a, size_t count) const;
+  [[nodiscard]] size_t bytes() const { return total; }
+
+private:
+  std::array<size_t, arrays> offset{};
+  std::array<size_t, arrays> capacity{};
+  size_t total;
+  char *base;
+};
+
+// Prints the field storage of every rank's tiles, bytes per cell and the total, on the boss. Collective.
+void report(const global_variables &globals, parallel_ &parallel, std::ostream &out);
+
+} // namespace clover::arena
+
+// Whether this model's buffers can take their storage from an arena, see definitions.cpp
+bool field_arena_supported();
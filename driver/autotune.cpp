@@ -0,0 +1,246 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Online autotuning of the execution knobs
+//  @details All ranks switch variants on the same step, as they all see the same
+//  step count and the same (reduced) step times, so no extra messages are needed
+//  to agree. Switching the halo exchange between steps is safe as every exchange
+//  completes within the step and the set up of all the strategies is done up front
+//  when tuning (see clover_allocate_buffers). A cache line reads
+//  "<key> <knob>=<variant> ...", with later lines for the same key replacing it.
+
+#include "autotune.h"
+#include "advec_cell.h"
+#include "comms_kernel.h"
+#include "ideal_gas.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+extern thread_local std::ostream g_out;
+
+namespace clover::tune {
+
+namespace {
+
+constexpr int trial_steps = 3;
+
+// Knobs are applied to the config during set up and to the running copies in global_variables after that
+struct knob {
+  std::string name;
+  std::vector<std::string> variants; // The variant in use when tuning starts comes first
+  std::function<void(halo_exchange_type &, advection_kernel_type &, store_type &, const std::string &)> apply;
+};
+
+struct state {
+  std::vector<knob> knobs;
+  std::string key;
+  size_t current = 0, variant = 0;
+  int steps = 0;
+  std::vector<double> fastest; // Per variant of the current knob
+  std::vector<std::string> chosen;
+};
+
+// Ranks may be threads of one process (see mpi_shim.h), so every rank tunes on its own copy
+thread_local state tuner;
+
+const char *halo_exchange_name(halo_exchange_type type) {
+  switch (type) {
+    case halo_exchange_type::pack: return "pack";
+    case halo_exchange_type::datatype: return "datatype";
+    case halo_exchange_type::shared: return "shared";
+    case halo_exchange_type::neighbour: return "neighbour";
+  }
+  return "pack";
+}
+
+const char *advection_name(advection_kernel_type type) { return type == advection_kernel_type::simd ? "simd" : "scalar"; }
+
+const char *stores_name(store_type type) { return type == store_type::streaming ? "streaming" : "normal"; }
+
+std::vector<knob> knobs_of(const parallel_ &parallel, const global_config &config) {
+  std::vector<knob> knobs;
+
+  // Exchanges between ranks only, so there is nothing to compare on one
+  knob halo{"halo_exchange", {halo_exchange_name(config.halo_exchange)},
+            [](halo_exchange_type &halo_exchange, advection_kernel_type &, store_type &, const std::string &variant) {
+              for (auto type : {halo_exchange_type::pack, halo_exchange_type::datatype, halo_exchange_type::shared,
+                                halo_exchange_type::neighbour})
+                if (variant == halo_exchange_name(type)) halo_exchange = type;
+            }};
+  for (auto type : {halo_exchange_type::pack, halo_exchange_type::datatype, halo_exchange_type::shared, halo_exchange_type::neighbour})
+    if (type != config.halo_exchange && clover_exchange_supported(type)) halo.variants.emplace_back(halo_exchange_name(type));
+  if (parallel.max_task > 1 && halo.variants.size() > 1) knobs.push_back(halo);
+
+  knob advection{"advection", {advection_name(config.advection_kernel)},
+                 [](halo_exchange_type &, advection_kernel_type &advection_kernel, store_type &, const std::string &variant) {
+                   advection_kernel = variant == "simd" ? advection_kernel_type::simd : advection_kernel_type::scalar;
+                 }};
+  advection.variants.emplace_back(advection_name(config.advection_kernel == advection_kernel_type::simd ? advection_kernel_type::scalar
+                                                                                                        : advection_kernel_type::simd));
+  if (advec_simd_supported()) knobs.push_back(advection);
+
+  knob stores{"stores", {stores_name(config.stores)}, [](halo_exchange_type &, advection_kernel_type &, store_type &stores, const std::string &variant) {
+                stores = variant == "streaming" ? store_type::streaming : store_type::normal;
+              }};
+  stores.variants.emplace_back(stores_name(config.stores == store_type::streaming ? store_type::normal : store_type::streaming));
+  if (streaming_stores_supported()) knobs.push_back(stores);
+
+  return knobs;
+}
+
+std::string cpu_name() {
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  for (std::string line; std::getline(cpuinfo, line);) {
+    if (line.rfind("model name", 0) == 0 && line.find(':') != std::string::npos) return line.substr(line.find(':') + 1);
+  }
+  return "unknown";
+}
+
+// Whitespace separates the fields of a cache line
+std::string token(std::string text) {
+  text.erase(0, text.find_first_not_of(' '));
+  std::replace_if(text.begin(), text.end(), [](char c) { return c == ' ' || c == '\t'; }, '_');
+  return text;
+}
+
+std::string key_of(const parallel_ &parallel, const global_config &config, const std::string &model) {
+  std::ostringstream key;
+  key << "model=" << token(model) << ";cpu=" << token(cpu_name()) << ";threads=" << std::thread::hardware_concurrency()
+      << ";cells=" << config.grid.x_cells << "x" << config.grid.y_cells << ";ranks=" << parallel.max_task;
+  return key.str();
+}
+
+// The cached variant of each knob for the key, empty strings where there is none
+std::vector<std::string> read_cache(const std::string &file, const std::string &key, const std::vector<knob> &knobs) {
+  std::vector<std::string> found(knobs.size());
+  std::ifstream in(file);
+  for (std::string line; std::getline(in, line);) {
+    std::istringstream fields(line);
+    std::string line_key;
+    if (!(fields >> line_key) || line_key != key) continue;
+    for (std::string field; fields >> field;) {
+      auto eq = field.find('=');
+      if (eq == std::string::npos) continue;
+      for (size_t k = 0; k < knobs.size(); ++k)
+        if (field.substr(0, eq) == knobs[k].name) found[k] = field.substr(eq + 1);
+    }
+  }
+  return found;
+}
+
+void write_cache(const std::string &file, const std::string &key, const std::vector<knob> &knobs, const std::vector<std::string> &chosen) {
+  std::vector<std::string> lines;
+  {
+    std::ifstream in(file);
+    for (std::string line; std::getline(in, line);) {
+      std::istringstream fields(line);
+      std::string line_key;
+      if (fields >> line_key && line_key != key) lines.push_back(line);
+    }
+  }
+  std::ostringstream entry;
+  entry << key;
+  for (size_t k = 0; k < knobs.size(); ++k)
+    entry << " " << knobs[k].name << "=" << chosen[k];
+  lines.push_back(entry.str());
+
+  std::ofstream out(file, std::ios::trunc);
+  for (const auto &line : lines)
+    out << line << "\n";
+  if (!out) g_out << "Autotune: unable to write " << file << std::endl;
+}
+
+} // namespace
+
+void setup(parallel_ &parallel, global_config &config, const std::string &model) {
+  tuner = state{};
+  tuner.knobs = knobs_of(parallel, config);
+  tuner.key = key_of(parallel, config, model);
+
+  // The boss looks the run up and hands every rank the index of each cached variant, -1 where there is none
+  std::vector<int> cached(tuner.knobs.size(), -1);
+  if (parallel.boss) {
+    auto found = read_cache(config.autotune, tuner.key, tuner.knobs);
+    for (size_t k = 0; k < tuner.knobs.size(); ++k) {
+      auto &variants = tuner.knobs[k].variants;
+      auto it = std::find(variants.begin(), variants.end(), found[k]);
+      if (it != variants.end()) cached[k] = int(it - variants.begin());
+    }
+  }
+  if (!cached.empty()) MPI_Bcast(cached.data(), int(cached.size()), MPI_INT, 0, g_comm);
+
+  bool complete = std::all_of(cached.begin(), cached.end(), [](int v) { return v >= 0; });
+  if (complete) {
+    for (size_t k = 0; k < tuner.knobs.size(); ++k)
+      tuner.knobs[k].apply(config.halo_exchange, config.advection_kernel, config.stores, tuner.knobs[k].variants[cached[k]]);
+    if (parallel.boss) {
+      g_out << "Autotune: " << (tuner.knobs.empty() ? "nothing to tune in this build" : "using the choices cached in " + config.autotune);
+      for (size_t k = 0; k < tuner.knobs.size(); ++k)
+        g_out << " " << tuner.knobs[k].name << "=" << tuner.knobs[k].variants[cached[k]];
+      g_out << std::endl << std::endl;
+    }
+    config.autotune.clear();
+    return;
+  }
+  tuner.fastest.assign(tuner.knobs.front().variants.size(), std::numeric_limits<double>::max());
+  if (parallel.boss) g_out << "Autotune: trying " << tuner.knobs.size() << " knob(s) for " << tuner.key << std::endl << std::endl;
+}
+
+void step(global_variables &globals, parallel_ &parallel, double seconds) {
+  if (globals.step <= globals.config.warmup_steps || tuner.current >= tuner.knobs.size()) return;
+
+  // A step is as slow as its slowest rank, and every rank has to see the same number to switch together
+  double slowest = -seconds;
+  clover_min(slowest);
+  tuner.fastest[tuner.variant] = std::min(tuner.fastest[tuner.variant], -slowest);
+  if (++tuner.steps < trial_steps) return;
+
+  knob &current = tuner.knobs[tuner.current];
+  auto apply = [&](size_t variant) { current.apply(globals.halo_exchange, globals.advection_kernel, globals.stores, current.variants[variant]); };
+  tuner.steps = 0;
+  if (++tuner.variant < current.variants.size()) {
+    apply(tuner.variant);
+    return;
+  }
+
+  auto best = size_t(std::min_element(tuner.fastest.begin(), tuner.fastest.end()) - tuner.fastest.begin());
+  apply(best);
+  tuner.chosen.push_back(current.variants[best]);
+  if (parallel.boss) {
+    g_out << "Autotune " << current.name << ":";
+    for (size_t v = 0; v < current.variants.size(); ++v)
+      g_out << " " << current.variants[v] << " " << tuner.fastest[v] << "s";
+    g_out << ", using " << current.variants[best] << std::endl;
+  }
+
+  if (++tuner.current < tuner.knobs.size()) {
+    tuner.variant = 0;
+    tuner.fastest.assign(tuner.knobs[tuner.current].variants.size(), std::numeric_limits<double>::max());
+    return;
+  }
+  if (parallel.boss) write_cache(globals.config.autotune, tuner.key, tuner.knobs, tuner.chosen);
+}
+
+} // namespace clover::tune
@@ -0,0 +1,49 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "comms.h"
+#include "definitions.h"
+
+#include <string>
+
+//  @brief Online autotuning of the execution knobs
+//  @details With --autotune, the steps after the warmup try every variant of each knob
+//  this build can switch between steps: the halo exchange strategy (MPI builds with
+//  more than one rank), the advection kernel (models with a SIMD kernel) and the
+//  stores of the write-only outputs (models with streaming stores). Each variant
+//  runs for a few steps and is scored by its fastest step, a step being as slow as
+//  its slowest rank. The fastest variant is kept before the next knob is tried. The
+//  choices go into a cache file, keyed by model, CPU, deck size and rank count, and
+//  a later run with the same key starts with them and skips the trials. Knobs fixed
+//  at compile time or at set up (RANGE2D_MODE, the OpenMP schedules, the tile
+//  layout) are not covered.
+namespace clover::tune {
+
+// Looks this run up in the cache on the boss and applies the cached choices on every rank, clearing
+// config.autotune when there is nothing left to try. Must be called on every rank before the simulation is set up.
+void setup(parallel_ &parallel, global_config &config, const std::string &model);
+
+// Scores the step just taken and moves on to the next variant or knob, switching globals.halo_exchange and
+// globals.advection_kernel, and writes the cache once every knob is decided. Must be called on every rank after
+// every step when globals.config.autotune is set.
+void step(global_variables &globals, parallel_ &parallel, double seconds);
+
+} // namespace clover::tune
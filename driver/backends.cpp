@@ -0,0 +1,108 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Launcher of a multi model build
+//  @details With -DMODELS=... every model is built, driver included, into its
+//  own cloverleaf-<model>.so next to this executable. The field storage and
+//  kernels of the models differ, so the whole run is what gets selected:
+//  --model picks the module, which is loaded with its symbols kept local and
+//  handed the remaining arguments. The first model in MODELS is the default.
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef CLOVER_BACKENDS
+  #error CLOVER_BACKENDS must list the models built as modules
+#endif
+
+namespace {
+
+std::vector<std::string> backends() {
+  std::vector<std::string> names;
+  std::stringstream ss(CLOVER_BACKENDS);
+  for (std::string name; std::getline(ss, name, ',');)
+    names.push_back(name);
+  return names;
+}
+
+// The modules are installed next to the executable, so look there first and then fall back to the loader's search path
+void *open_backend(const std::string &model) {
+  std::string file = "cloverleaf-" + model + ".so";
+  std::vector<char> self(4096);
+  if (auto len = readlink("/proc/self/exe", self.data(), self.size() - 1); len > 0) {
+    std::string dir(self.data(), len);
+    if (auto slash = dir.rfind('/'); slash != std::string::npos) {
+      // a module that is there but fails to load should report why, not that it is missing
+      if (auto path = dir.substr(0, slash + 1) + file; access(path.c_str(), F_OK) == 0) return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    }
+  }
+  return dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  auto names = backends();
+  std::string model = names.front();
+
+  // strip --model so the backend's own option parsing never sees it
+  std::vector<char *> args{argv[0]};
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--model") == 0) {
+      if (i + 1 >= argc) {
+        std::cerr << "--model requires a model name, available: " << CLOVER_BACKENDS << std::endl;
+        return EXIT_FAILURE;
+      }
+      model = argv[++i];
+    } else {
+      if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+        std::cout << "\n"
+                  << "      --model                  <NAME>    Execution backend, one of " << CLOVER_BACKENDS << " (defaults to "
+                  << names.front() << ")" << std::endl;
+      }
+      args.push_back(argv[i]);
+    }
+  }
+  args.push_back(nullptr);
+
+  if (std::find(names.begin(), names.end(), model) == names.end()) {
+    std::cerr << "Unknown model `" << model << "`, this build has: " << CLOVER_BACKENDS << std::endl;
+    return EXIT_FAILURE;
+  }
+  void *handle = open_backend(model);
+  if (!handle) {
+    std::cerr << "Unable to load the " << model << " backend: " << dlerror() << std::endl;
+    return EXIT_FAILURE;
+  }
+  using entry = int (*)(int, char **);
+  auto run = reinterpret_cast<entry>(dlsym(handle, "clover_backend_main"));
+  if (!run) {
+    std::cerr << "The " << model << " backend has no entry point: " << dlerror() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return run(static_cast<int>(args.size() - 1), args.data());
+}
@@ -35,30 +35,55 @@
 //  volume, though constant for all cells, should remain array and not be
 //  converted to a scalar.
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
+#include "advec_cell.h"
+#include "arena.h"
+#include "cloverleaf.h"
 #include "comms.h"
+#include "comms_kernel.h"
 #include "definitions.h"
-#include "finalise.h"
-#include "hydro.h"
+#include "ideal_gas.h"
 #include "initialise.h"
+#include "logging.h"
+#include "perf_counters.h"
 #include "read_input.h"
 #include "report.h"
-#include "start.h"
+#include "reset_field.h"
+#include "timer.h"
+#include "trace.h"
 #include "version.h"
 
-// Output file handler
-std::ostream g_out(nullptr);
+thread_local std::ofstream of;
+// Ring between g_out and clover.out on the boss, released before the file is closed
+thread_local std::unique_ptr<clover::logging::buffered> out_buffer;
 
-std::ofstream of;
+static const char *halo_exchange_name(halo_exchange_type type) {
+  switch (type) {
+    case halo_exchange_type::pack: return "pack";
+    case halo_exchange_type::datatype: return "datatype";
+    case halo_exchange_type::shared: return "shared";
+    case halo_exchange_type::neighbour: return "neighbour";
+  }
+  return "unknown";
+}
 
-global_variables initialise(parallel_ &parallel, const std::vector<std::string> &args) {
+// Settings that come from the command line rather than the deck, then the banner on stdout
+static global_config configure(parallel_ &parallel, const model &model) {
   global_config config;
-  if (parallel.boss) {
-    std::cout << "---" << std::endl;
-  }
-  auto model = create_context(!parallel.boss, args);
   config.dumpDir = model.args.dumpDir;
+#ifdef NO_MPI
+  // Ranks are threads of this process, so there is a single trace and the boss owns it
+  if (!model.args.tracePrefix.empty() && parallel.boss) clover::trace::start(model.args.tracePrefix, parallel.task);
+#else
+  if (!model.args.tracePrefix.empty()) clover::trace::start(model.args.tracePrefix, parallel.task);
+#endif
+  // Before any parallel region, so the inherited counters see every worker thread
+  if (model.args.perfCounters) clover::counters::start(!parallel.boss);
+  clover::logging::configure(model.args.logLevel, model.args.logEvery);
 
 #ifdef NO_MPI
   bool mpi_enabled = false;
@@ -93,12 +118,61 @@ global_variables initialise(parallel_ &parallel, const std::vector<std::string>
       break;
   }
 
+  config.halo_exchange = model.args.halo_exchange;
+  if (!clover_exchange_supported(config.halo_exchange)) {
+    if (parallel.boss)
+      std::cout << "# WARNING: --halo-exchange " << halo_exchange_name(config.halo_exchange)
+                << " is not available for this model or build, using pack" << std::endl;
+    config.halo_exchange = halo_exchange_type::pack;
+  }
+  config.advection_kernel = model.args.advection_kernel;
+  config.reproducible = model.args.reproducible;
+  if (config.advection_kernel == advection_kernel_type::simd && !advec_simd_supported()) {
+    if (parallel.boss) std::cout << "# WARNING: --advection simd is not available for this model, using scalar" << std::endl;
+    config.advection_kernel = advection_kernel_type::scalar;
+  }
+  config.stores = model.args.stores;
+  if (config.stores == store_type::streaming && !streaming_stores_supported()) {
+    if (parallel.boss) std::cout << "# WARNING: --stores streaming is not available for this model, using normal" << std::endl;
+    config.stores = store_type::normal;
+  }
+  config.fused_summary = model.args.fusedSummary;
+  if (config.fused_summary && !fused_summary_supported()) {
+    if (parallel.boss) std::cout << "# WARNING: --fused-summary is not available for this model, ignoring" << std::endl;
+    config.fused_summary = false;
+  }
+  config.arena = model.args.arena.value_or(field_arena_supported() ? arena_type::packed : arena_type::off);
+  if (config.arena != arena_type::off && !field_arena_supported()) {
+    if (model.args.arena && parallel.boss)
+      std::cout << "# WARNING: --arena " << clover::arena::layout_name(config.arena) << " is not available for this model, using off" << std::endl;
+    config.arena = arena_type::off;
+  }
+  // The dumps after each phase would show the work arrays in the aliased fields
+  if (config.arena == arena_type::aliased && !config.dumpDir.empty()) {
+    if (parallel.boss) std::cout << "# WARNING: --arena aliased is not available with --dump, using packed" << std::endl;
+    config.arena = arena_type::packed;
+  }
+  config.autotune = model.args.tuneCache;
+  if (model.offload && model.args.hugePages != clover::pages::policy::off) {
+    if (parallel.boss) std::cout << "# WARNING: --huge-pages only applies to host allocations, the device fields are unaffected" << std::endl;
+  }
+  clover::pages::set_policy(model.args.hugePages);
+  // Ensemble members run on a single rank each, so their halos never leave the rank
+  if (!model.args.ensembleFile.empty()) config.halo_exchange = halo_exchange_type::pack;
+  if (!model.args.ensembleFile.empty() && !config.autotune.empty()) {
+    if (parallel.boss) std::cout << "# WARNING: --autotune is not available with --ensemble, ignoring" << std::endl;
+    config.autotune.clear();
+  }
+
   if (parallel.boss) {
     std::cout << "CloverLeaf:\n"
               << " - Ver.:     " << g_version << "\n"
-              << " - Deck:     " << model.args.inFile << "\n"
+              << " - Deck:     " << (model.args.ensembleFile.empty() ? model.args.inFile : "ensemble") << "\n"
+              << " - Ensemble: " << (model.args.ensembleFile.empty() ? "off" : model.args.ensembleFile) << "\n"
               << " - Out:      " << model.args.outFile << "\n"
               << " - Profiler: " << (model.args.profile ? (*model.args.profile ? "true" : "false") : "deck-specified") << "\n"
+              << " - Counters: " << (clover::counters::enabled ? "true" : "false") << "\n"
+              << " - Trace:    " << (model.args.tracePrefix.empty() ? "off" : model.args.tracePrefix + "_<rank>.json") << "\n"
               << "MPI:\n"
               << " - Enabled:     " << (mpi_enabled ? "true" : "false") << "\n"
               << " - Total ranks: " << parallel.max_task << "\n"
@@ -107,20 +181,59 @@ global_variables initialise(parallel_ &parallel, const std::vector<std::string>
               << " - Runtime device-awareness (CUDA-awareness): "
               << (mpi_cuda_aware_runtime ? (*mpi_cuda_aware_runtime ? "true" : "false") : "unknown") << "\n"
               << " - Host-Device halo exchange staging buffer:  " << (config.staging_buffer ? "true" : "false") << "\n"
+              << " - Halo exchange: " << halo_exchange_name(config.halo_exchange) << "\n"
               << "Model:\n"
               << " - Name:      " << model.name << "\n"
-              << " - Execution: " << (model.offload ? "Offload (device)" : "Host") //
+              << " - Execution: " << (model.offload ? "Offload (device)" : "Host") << "\n"
+              << " - Advection: " << (config.advection_kernel == advection_kernel_type::simd ? "simd" : "scalar") << "\n"
+              << " - Stores:    " << (config.stores == store_type::streaming ? "streaming" : "normal") << "\n"
+              << " - Reproducible summaries: " << (config.reproducible ? "true" : "false") << "\n"
+              << " - Fused summaries:        " << (config.fused_summary ? "true" : "false") << "\n"
+              << " - Autotune:  " << (config.autotune.empty() ? "off" : config.autotune) << "\n"
+              << " - Field arena: " << clover::arena::layout_name(config.arena) << "\n"
+              << " - Huge pages: " << clover::pages::policy_name(model.args.hugePages) //
               << std::endl;
     report_context(model.context);
     std::cout << "# ---- " << std::endl;
     std::cout << "Output: |+1" << std::endl;
   }
+  return config;
+}
+
+// Reads the deck on the boss and generates the problem on every rank of the communicator
+static clover::simulation initialise_run(parallel_ &parallel, const model &model, global_config config, std::istream &g_in) {
+  clover_barrier();
+  if (parallel.boss) {
+    g_out << std::endl << "Initialising and generating" << std::endl << std::endl;
+    read_input(g_in, parallel, config);
+  }
+  clover_broadcast_config(parallel, config);
+  if (model.args.profile) {
+    config.profiler_on = *model.args.profile;
+  }
+  clover_barrier();
+
+  clover::simulation simulation(config, model.context, g_comm, model.name);
+  clover_barrier(simulation.variables());
+  if (parallel.boss) {
+    g_out << "Starting the calculation" << std::endl;
+  }
+  return simulation;
+}
+
+clover::simulation initialise(parallel_ &parallel, const std::vector<std::string> &args) {
+  if (parallel.boss) {
+    std::cout << "---" << std::endl;
+  }
+  auto model = create_context(!parallel.boss, args);
+  global_config config = configure(parallel, model);
 
   if (parallel.boss) {
     std::cout << " Output file clover.out opened. All output will go there." << std::endl;
     of.open(model.args.outFile.empty() ? "clover.out" : model.args.outFile);
     if (!of.is_open()) report_error((char *)"initialise", (char *)"Error opening clover.out file.");
     g_out.rdbuf(of.rdbuf());
+    out_buffer = std::make_unique<clover::logging::buffered>(g_out, model.args.logBuffer);
   } else {
     g_out.rdbuf(std::cout.rdbuf());
   }
@@ -144,70 +257,60 @@ global_variables initialise(parallel_ &parallel, const std::vector<std::string>
     }
   }
 
-  if (!model.args.inFile.empty()) {
-    if (parallel.boss) std::cout << " Using input: `" << model.args.inFile << "`" << std::endl;
-    g_in.open(model.args.inFile);
-    if (g_in.fail()) {
-      std::cerr << "Unable to open file: `" << model.args.inFile << "`" << std::endl;
-      std::exit(1);
-    }
-  } else {
-    if (parallel.boss) std::cout << "No input file specified, using default input" << std::endl;
-    std::ofstream out_unit("clover.in");
-    out_unit << "*clover" << std::endl
-             << " state 1 density=0.2 energy=1.0" << std::endl
-             << " state 2 density=1.0 energy=2.5 geometry=rectangle xmin=0.0 xmax=5.0 ymin=0.0 ymax=2.0" << std::endl
-             << " x_cells=10" << std::endl
-             << " y_cells=2" << std::endl
-             << " xmin=0.0" << std::endl
-             << " ymin=0.0" << std::endl
-             << " xmax=10.0" << std::endl
-             << " ymax=2.0" << std::endl
-             << " initial_timestep=0.04" << std::endl
-             << " timestep_rise=1.5" << std::endl
-             << " max_timestep=0.04" << std::endl
-             << " end_time=3.0" << std::endl
-             << " test_problem 1" << std::endl
-             << "*endclover" << std::endl;
-    out_unit.close();
-    g_in.open("clover.in");
-  }
-  //}
-
-  clover_barrier();
+  // Only the boss touches the deck, the parsed config is broadcast to everyone else after read_input
   if (parallel.boss) {
-    g_out << std::endl << "Initialising and generating" << std::endl << std::endl;
-  }
-  read_input(g_in, parallel, config);
-  if (model.args.profile) {
-    config.profiler_on = *model.args.profile;
+    if (!model.args.inFile.empty()) {
+      std::cout << " Using input: `" << model.args.inFile << "`" << std::endl;
+      g_in.open(model.args.inFile);
+      if (g_in.fail()) {
+        std::cerr << "Unable to open file: `" << model.args.inFile << "`" << std::endl;
+        clover_abort();
+      }
+    } else {
+      std::cout << "No input file specified, using default input" << std::endl;
+      std::ofstream out_unit("clover.in");
+      out_unit << "*clover" << std::endl
+               << " state 1 density=0.2 energy=1.0" << std::endl
+               << " state 2 density=1.0 energy=2.5 geometry=rectangle xmin=0.0 xmax=5.0 ymin=0.0 ymax=2.0" << std::endl
+               << " x_cells=10" << std::endl
+               << " y_cells=2" << std::endl
+               << " xmin=0.0" << std::endl
+               << " ymin=0.0" << std::endl
+               << " xmax=10.0" << std::endl
+               << " ymax=2.0" << std::endl
+               << " initial_timestep=0.04" << std::endl
+               << " timestep_rise=1.5" << std::endl
+               << " max_timestep=0.04" << std::endl
+               << " end_time=3.0" << std::endl
+               << " test_problem 1" << std::endl
+               << "*endclover" << std::endl;
+      out_unit.close();
+      g_in.open("clover.in");
+    }
   }
 
-  clover_barrier();
-
-  //	globals.step = 0;
-  config.number_of_chunks = parallel.max_task;
-
-  auto globals = start(parallel, config, model.context);
-  clover_barrier(globals);
-  if (parallel.boss) {
-    g_out << "Starting the calculation" << std::endl;
-  }
+  auto simulation = initialise_run(parallel, model, config, g_in);
   g_in.close();
-  return globals;
+  return simulation;
 }
 
-int main(int argc, char *argv[]) {
+// Runs one rank from set up to the final result
+static int run(const std::vector<std::string> &args) {
 
-  MPI_Init(&argc, &argv);
   parallel_ parallel;
-  global_variables config = initialise(parallel, std::vector<std::string>(argv + 1, argv + argc));
+  auto simulation = initialise(parallel, args);
   if (parallel.boss) {
     std::cout << " Launching hydro" << std::endl;
   }
-  hydro(config, parallel);
-  finalise(config);
+  simulation.run();
+  out_buffer.reset();
+  const global_variables &config = simulation.variables();
   MPI_Finalize();
+#ifdef NO_MPI
+  if (parallel.boss) clover::trace::finish();
+#else
+  clover::trace::finish();
+#endif
 
   if (parallel.boss) {
     std::cout << "Result:\n"
@@ -216,3 +319,189 @@ int main(int argc, char *argv[]) {
   }
   return config.report_test_fail ? EXIT_FAILURE : EXIT_SUCCESS;
 }
+
+// One line of an --ensemble list, the deck and the deck lines that override it
+struct ensemble_member {
+  std::string deck;
+  std::vector<std::string> overrides;
+};
+
+static std::vector<ensemble_member> read_ensemble(const std::string &file) {
+  std::ifstream in(file);
+  if (in.fail()) {
+    std::cerr << "Unable to open ensemble file: `" << file << "`" << std::endl;
+    clover_abort();
+  }
+  const auto trim = [](const std::string &s) {
+    auto first = s.find_first_not_of(" \t\r");
+    return first == std::string::npos ? std::string() : s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+  };
+  std::vector<ensemble_member> members;
+  for (std::string line; std::getline(in, line);) {
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) continue;
+    std::istringstream fields(line);
+    ensemble_member member;
+    std::getline(fields, member.deck, ';');
+    member.deck = trim(member.deck);
+    for (std::string field; std::getline(fields, field, ';');)
+      if (!trim(field).empty()) member.overrides.push_back(" " + trim(field));
+    members.push_back(member);
+  }
+  if (members.empty()) {
+    std::cerr << "No members in ensemble file: `" << file << "`" << std::endl;
+    clover_abort();
+  }
+  return members;
+}
+
+// clover.out becomes clover_<member>.out
+static std::string member_file(const std::string &out, size_t member) {
+  auto dot = out.find_last_of('.');
+  if (dot == std::string::npos || out.find('/', dot) != std::string::npos) return out + "_" + std::to_string(member);
+  return out.substr(0, dot) + "_" + std::to_string(member) + out.substr(dot);
+}
+
+// Runs every deck of an --ensemble list in this process. Members are handed round-robin to the ranks and each runs
+// on MPI_COMM_SELF, reusing the model context this rank created once, so a member only pays for its own generation
+// and steps. The per-member results are summed over MPI_COMM_WORLD into one table on the boss.
+static int run_ensemble(const std::vector<std::string> &args) {
+
+  parallel_ parallel;
+  if (parallel.boss) {
+    std::cout << "---" << std::endl;
+  }
+  auto model = create_context(!parallel.boss, args);
+  auto members = read_ensemble(model.args.ensembleFile);
+  global_config config = configure(parallel, model);
+  std::string out = model.args.outFile.empty() ? "clover.out" : model.args.outFile;
+  if (parallel.boss) {
+    std::cout << " Running " << members.size() << " members over " << parallel.max_task << " rank(s), see " << member_file(out, 0)
+              << " onwards" << std::endl;
+  }
+
+  enum { steps, time, wall, vol, mass, ie, ke, press, failed, results };
+  std::vector<double> local(members.size() * results, 0.0);
+
+  g_comm = MPI_COMM_SELF;
+  for (size_t m = parallel.task; m < members.size(); m += parallel.max_task) {
+    const auto &member = members[m];
+    parallel_ self;
+
+    of.open(member_file(out, m));
+    if (!of.is_open()) report_error((char *)"run_ensemble", (char *)"Error opening member output file.");
+    g_out.rdbuf(of.rdbuf());
+    g_out << "Clover Version " << g_version << std::endl //
+          << "Ensemble member " << m << " of " << members.size() << std::endl
+          << "Task Count " << self.max_task << std::endl
+          << std::endl;
+
+    std::ifstream in(member.deck);
+    if (in.fail()) {
+      std::cerr << "Unable to open file: `" << member.deck << "`" << std::endl;
+      clover_abort();
+    }
+    // read_input takes the last value of a key, so the overrides go after the deck
+    std::stringstream deck;
+    deck << in.rdbuf() << "\n";
+    for (const auto &line : member.overrides)
+      deck << line << "\n";
+
+    global_config member_config = config;
+    if (!member_config.dumpDir.empty()) member_config.dumpDir = member_file(config.dumpDir, m);
+
+    double started = timer();
+    out_buffer = std::make_unique<clover::logging::buffered>(g_out, model.args.logBuffer);
+    auto simulation = initialise_run(self, model, member_config, deck);
+    simulation.run();
+    out_buffer.reset();
+    of.close();
+
+    const global_variables &globals = simulation.variables();
+    double *row = local.data() + m * results;
+    row[steps] = globals.step;
+    row[time] = globals.time;
+    row[wall] = timer() - started;
+    row[vol] = globals.summary.vol;
+    row[mass] = globals.summary.mass;
+    row[ie] = globals.summary.ie;
+    row[ke] = globals.summary.ke;
+    row[press] = globals.summary.press;
+    row[failed] = globals.report_test_fail;
+  }
+  g_comm = MPI_COMM_WORLD;
+
+  // Every member was run by exactly one rank and the other rows are zero, so a sum gathers the table
+  std::vector<double> table(local.size());
+  MPI_Allreduce(local.data(), table.data(), static_cast<int>(local.size()), MPI_DOUBLE, MPI_SUM, g_comm);
+
+  bool any_failed = false;
+  for (size_t m = 0; m < members.size(); ++m)
+    any_failed |= table[m * results + failed] != 0;
+
+  if (parallel.boss) {
+    std::ofstream summary(out);
+    if (!summary.is_open()) report_error((char *)"run_ensemble", (char *)"Error opening clover.out file.");
+    summary << "Clover Version " << g_version << std::endl
+            << "Ensemble " << model.args.ensembleFile << " of " << members.size() << " members over " << parallel.max_task
+            << " rank(s)" << std::endl
+            << std::endl
+            << "member  step  time           wall           volume         mass           density        pressure       "
+               "internal energy kinetic energy total energy   test  deck"
+            << std::endl;
+    for (size_t m = 0; m < members.size(); ++m) {
+      const double *row = table.data() + m * results;
+      summary << std::setw(6) << m << std::setw(6) << static_cast<int>(row[steps]) << std::scientific;
+      for (double value : {row[time], row[wall], row[vol], row[mass], row[mass] / row[vol], row[press] / row[vol], row[ie], row[ke],
+                           row[ie] + row[ke]})
+        summary << std::setw(15) << value;
+      summary << std::defaultfloat << "  " << (row[failed] != 0 ? "FAIL" : "pass") << "  " << members[m].deck;
+      for (const auto &line : members[m].overrides)
+        summary << ";" << line;
+      summary << std::endl;
+    }
+  }
+  MPI_Finalize();
+#ifdef NO_MPI
+  if (parallel.boss) clover::trace::finish();
+#else
+  clover::trace::finish();
+#endif
+
+  if (parallel.boss) {
+    std::cout << "Result:\n"
+              << " - Members: " << members.size() << "\n"
+              << " - Summary: " << out << "\n"
+              << " - Outcome: " << (any_failed ? "FAILED" : "PASSED") << std::endl;
+  }
+  return any_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int clover_main(int argc, char *argv[]) {
+
+  MPI_Init(&argc, &argv);
+  std::vector<std::string> args(argv + 1, argv + argc);
+  // stdout is shared by every rank of the process, so its ring has to outlive all of them; list_and_parse validates the
+  // rest of the options later
+  size_t log_buffer = clover::logging::default_capacity;
+  if (auto it = std::find(args.begin(), args.end(), "--log-buffer"); it != args.end() && std::next(it) != args.end())
+    log_buffer = std::strtoull(std::next(it)->c_str(), nullptr, 10);
+  clover::logging::buffered console(std::cout, log_buffer);
+#ifdef NO_MPI
+  // The rank count is needed before any rank exists, list_and_parse validates it again later
+  int ranks = 1;
+  if (auto it = std::find(args.begin(), args.end(), "--ranks"); it != args.end() && std::next(it) != args.end())
+    ranks = std::atoi(std::next(it)->c_str());
+  bool ensemble = std::find(args.begin(), args.end(), "--ensemble") != args.end();
+  return clover::shim::run(ranks, [&]() { return ensemble ? run_ensemble(args) : run(args); });
+#else
+  return std::find(args.begin(), args.end(), "--ensemble") != args.end() ? run_ensemble(args) : run(args);
+#endif
+}
+
+#ifdef CLOVER_BACKEND
+// Entry point of a backend module, the cloverleaf launcher (backends.cpp) picks the module with --model and calls this
+extern "C" __attribute__((visibility("default"))) int clover_backend_main(int argc, char *argv[]) { return clover_main(argc, argv); }
+#else
+int main(int argc, char *argv[]) { return clover_main(argc, argv); }
+#endif
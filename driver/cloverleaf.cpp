@@ -0,0 +1,123 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cloverleaf.h"
+#include "autotune.h"
+#include "field_summary.h"
+#include "finalise.h"
+#include "hydro.h"
+#include "read_input.h"
+#include "start.h"
+#include "timer.h"
+
+#include <utility>
+
+thread_local std::ostream g_out(nullptr);
+
+namespace {
+
+// The driver's collectives all go through g_comm, so it points at the simulation's communicator for the length of a call
+struct comm_scope {
+  MPI_Comm previous;
+  explicit comm_scope(MPI_Comm comm) : previous(std::exchange(g_comm, comm)) {}
+  ~comm_scope() { g_comm = previous; }
+};
+
+} // namespace
+
+global_config clover::default_config() {
+  global_config config{};
+  config.staging_buffer = true; // Correct whether or not MPI is device-aware
+  config.halo_exchange = halo_exchange_type::pack;
+  config.advection_kernel = advection_kernel_type::scalar;
+  config.stores = store_type::normal;
+  config.reproducible = false;
+  config.fused_summary = false;
+  config.arena = arena_type::off;
+  read_input_defaults(config);
+  return config;
+}
+
+clover::simulation::simulation(global_config config, context ctx, MPI_Comm comm, const std::string &model) : comm(comm), parallel(comm) {
+  comm_scope scope(comm);
+
+  // If a state boundary falls exactly on a cell boundary then round off can
+  // cause the state to be put one cell further that expected. This is compiler
+  // /system dependent. To avoid this, a state boundary is reduced/increased by a 100th
+  // of a cell width so it lies well with in the intended cell.
+  // Because a cell is either full or empty of a specified state, this small
+  // modification to the state extents does not change the answers.
+  config.number_of_states = static_cast<int>(config.states.size());
+  double dx, dy;
+  dx = (config.grid.xmax - config.grid.xmin) / (float)config.grid.x_cells;
+  dy = (config.grid.ymax - config.grid.ymin) / (float)config.grid.y_cells;
+  for (int n = 1; n < config.number_of_states; ++n) {
+    config.states[n].xmin += dx / 100.0;
+    config.states[n].ymin += dy / 100.0;
+    config.states[n].xmax -= dx / 100.0;
+    config.states[n].ymax -= dy / 100.0;
+  }
+
+  config.number_of_chunks = parallel.max_task;
+  if (!config.autotune.empty()) clover::tune::setup(parallel, config, model);
+
+  globals = std::make_unique<global_variables>(start(parallel, config, ctx));
+}
+
+clover::simulation::~simulation() {
+  if (globals) finalise(*globals);
+}
+
+int clover::simulation::step(int n) {
+  comm_scope scope(comm);
+  int taken = 0;
+  for (; taken < n && !globals->complete; ++taken) {
+    double step_time = timer();
+    hydro_step(*globals, parallel);
+    if (!globals->config.autotune.empty()) clover::tune::step(*globals, parallel, timer() - step_time);
+    if (hydro_done(*globals)) hydro_complete(*globals, parallel);
+  }
+  return taken;
+}
+
+int clover::simulation::advance_to(double time) {
+  int taken = 0;
+  while (!globals->complete && globals->time + g_small < time)
+    taken += step(1);
+  return taken;
+}
+
+void clover::simulation::run() {
+  if (globals->complete) return;
+  comm_scope scope(comm);
+  hydro(*globals, parallel);
+}
+
+summary_type clover::simulation::summary() {
+  comm_scope scope(comm);
+  // The final summary is already there, taking it again would report the test problem twice
+  if (!globals->complete) field_summary(*globals, parallel);
+  summary_type &s = globals->summary;
+  double values[] = {s.vol, s.mass, s.ie, s.ke, s.press};
+  MPI_Bcast(values, 5, MPI_DOUBLE, 0, comm);
+  s = {values[0], values[1], values[2], values[3], values[4]};
+  return s;
+}
+
+clover::field_view clover::simulation::field(int tile, int field) { return clover_field_view(*globals, tile, field); }
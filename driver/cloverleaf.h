@@ -0,0 +1,83 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Step-level API of libcloverleaf
+//  @details Lets another code create a simulation in-process from a global_config, advance it, read back the field
+//  summary and look at the tile fields without copies. The cloverleaf executable (clover_leaf.cpp) is one such client.
+//  MPI must be initialised by the caller (MPI_Init, or clover::shim::run without MPI) before a simulation is created.
+
+#pragma once
+
+#include "comms.h"
+#include "definitions.h"
+#include "field_view.h"
+
+#include <memory>
+#include <ostream>
+#include <string>
+
+// Text output of the driver, one per thread as without MPI the ranks are threads of this process.
+// Discarded unless pointed somewhere with g_out.rdbuf(...).
+extern thread_local std::ostream g_out;
+
+namespace clover {
+
+// A config with every deck default filled in, including one chunk and tile per task.
+// Callers still have to describe the grid and the states, state 1 being the background.
+global_config default_config();
+
+class simulation {
+  MPI_Comm comm;
+  parallel_ parallel;
+  std::unique_ptr<global_variables> globals;
+
+public:
+  // Generates config on this rank, collective over comm. config is what read_input would have produced from a deck,
+  // the states are nudged off cell boundaries here like a deck's are. With config.autotune set, step() and run() tune
+  // the knobs as --autotune does, and model names the build in the cache key (see autotune.h).
+  simulation(global_config config, context ctx, MPI_Comm comm = MPI_COMM_WORLD, const std::string &model = "library");
+  simulation(simulation &&) noexcept = default;
+  simulation &operator=(simulation &&) noexcept = default;
+  ~simulation();
+
+  // Advances up to n steps, fewer if end_time or end_step comes first, and returns the number taken
+  int step(int n = 1);
+  // Advances until the simulated time reaches (or passes) time, or the run completes, and returns the steps taken
+  int advance_to(double time);
+  // Runs to completion with the usual per step and final reports, as the executable does
+  void run();
+
+  // The field summary of the current step, collective over comm and valid on every rank
+  summary_type summary();
+
+  // Read-only view of a field (a field_parameter) of one of this rank's tiles, see field_view.h, and arena.h for what an
+  // aliased arena leaves in it between steps
+  [[nodiscard]] field_view field(int tile, int field);
+
+  [[nodiscard]] int tiles() const { return globals->config.tiles_per_chunk; }
+  [[nodiscard]] const tile_info &tile(int t) const { return globals->chunk.tiles[t].info; }
+  [[nodiscard]] int steps() const { return globals->step; }
+  [[nodiscard]] double time() const { return globals->time; }
+  [[nodiscard]] double dt() const { return globals->dt; }
+  [[nodiscard]] bool complete() const { return globals->complete; }
+  [[nodiscard]] const parallel_ &ranks() const { return parallel; }
+  [[nodiscard]] global_variables &variables() { return *globals; }
+};
+
+} // namespace clover
@@ -33,83 +33,102 @@
 
 #include "comms.h"
 #include "context.h"
+#include "logging.h"
 #include "pack_kernel.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <type_traits>
 
-extern std::ostream g_out;
+extern thread_local std::ostream g_out;
+
+thread_local MPI_Comm g_comm = MPI_COMM_WORLD;
 
 // Set up parallel structure
-parallel_::parallel_() {
+parallel_::parallel_() : parallel_(g_comm) {}
+
+parallel_::parallel_(MPI_Comm comm) {
 
   parallel = true;
-  MPI_Comm_rank(MPI_COMM_WORLD, &task);
-  MPI_Comm_size(MPI_COMM_WORLD, &max_task);
+  MPI_Comm_rank(comm, &task);
+  MPI_Comm_size(comm, &max_task);
 
   boss = task == 0;
 }
 
-void clover_abort() { MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE); }
+void clover_abort() {
+  clover::logging::drain_all();
+  MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+}
 
-void clover_barrier() { MPI_Barrier(MPI_COMM_WORLD); }
+void clover_barrier() { MPI_Barrier(g_comm); }
 
 void clover_barrier(global_variables &globals) {
   clover_barrier();
 }
 
-//  This decomposes the mesh into a number of chunks.
-//  The number of chunks may be a multiple of the number of mpi tasks
+//  Splits count pieces into nx by ny so the ratio of the factors is as close to ratio as possible.
 //  Doesn't always return the best split if there are few factors
 //  All factors need to be stored and the best picked. But its ok for now
-std::array<int, 4> clover_decompose(const global_config &globals, parallel_ &parallel, int x_cells, int y_cells, int &left, int &right,
-                                    int &bottom, int &top) {
-
-  std::array<int, 4> chunk_neighbours{};
-
-  int number_of_chunks = globals.number_of_chunks;
-
-  // 2D Decomposition of the mesh
-
-  double mesh_ratio = (double)x_cells / (double)y_cells;
+static void clover_factorise(int count, double ratio, int &nx, int &ny) {
 
-  int chunk_x = number_of_chunks;
-  int chunk_y = 1;
+  nx = count;
+  ny = 1;
 
   int split_found = 0; // Used to detect 1D decomposition
 
   double factor_x, factor_y;
 
-  for (int c = 1; c <= number_of_chunks; ++c) {
-    if (number_of_chunks % c == 0) {
-      factor_x = number_of_chunks / (double)c;
+  for (int c = 1; c <= count; ++c) {
+    if (count % c == 0) {
+      factor_x = count / (double)c;
       factor_y = c;
       // Compare the factor ratio with the mesh ratio
-      if (factor_x / factor_y <= mesh_ratio) {
-        chunk_y = c;
-        chunk_x = number_of_chunks / c;
+      if (factor_x / factor_y <= ratio) {
+        ny = c;
+        nx = count / c;
         split_found = 1;
         break;
       }
     }
   }
 
-  if (split_found == 0 || chunk_y == number_of_chunks) { // Prime number or 1D decomp detected
-    if (mesh_ratio >= 1.0) {
-      chunk_x = number_of_chunks;
-      chunk_y = 1;
+  if (split_found == 0 || ny == count) { // Prime number or 1D decomp detected
+    if (ratio >= 1.0) {
+      nx = count;
+      ny = 1;
     } else {
-      chunk_x = 1;
-      chunk_y = number_of_chunks;
+      nx = 1;
+      ny = count;
     }
   }
+}
+
+//  This decomposes the mesh into a number of chunks.
+//  There is one chunk per mpi task, numbered from 1 row by row, and chunk_tasks maps each of them back to its owner.
+std::array<int, 4> clover_decompose(const global_config &globals, parallel_ &parallel, int x_cells, int y_cells, int &left, int &right,
+                                    int &bottom, int &top, std::vector<int> &chunk_tasks) {
+
+  std::array<int, 4> chunk_neighbours{};
+
+  int number_of_chunks = globals.number_of_chunks;
+
+  // 2D Decomposition of the mesh
+
+  double mesh_ratio = (double)x_cells / (double)y_cells;
+
+  int chunk_x, chunk_y;
+  clover_factorise(number_of_chunks, mesh_ratio, chunk_x, chunk_y);
 
   int delta_x = x_cells / chunk_x;
   int delta_y = y_cells / chunk_y;
   int mod_x = x_cells % chunk_x;
   int mod_y = y_cells % chunk_y;
 
-  // Set up chunk mesh ranges and chunk connectivity
+  // Set up chunk mesh ranges, the chunk to task map and chunk connectivity
 
+  chunk_tasks.resize(number_of_chunks);
   int add_x_prev = 0;
   int add_y_prev = 0;
   int cnk = 1;
@@ -120,6 +139,8 @@ std::array<int, 4> clover_decompose(const global_config &globals, parallel_ &par
       if (cx <= mod_x) add_x = 1;
       if (cy <= mod_y) add_y = 1;
 
+      chunk_tasks[cnk - 1] = cnk - 1;
+
       if (cnk == parallel.task + 1) {
         left = (cx - 1) * delta_x + 1 + add_x_prev;
         right = left + delta_x - 1 + add_x;
@@ -148,96 +169,50 @@ std::array<int, 4> clover_decompose(const global_config &globals, parallel_ &par
   if (parallel.boss) {
     g_out << std::endl
           << "Mesh ratio of " << mesh_ratio << std::endl
-          << "Decomposing the mesh into " << chunk_x << " by " << chunk_y << " chunks" << std::endl
-          << "Decomposing the chunk with " << globals.tiles_per_chunk << " tiles" << std::endl
-          << std::endl;
+          << "Decomposing the mesh into " << chunk_x << " by " << chunk_y << " chunks" << std::endl;
+    if (globals.tiles_per_chunk > 0) g_out << "Decomposing the chunk with " << globals.tiles_per_chunk << " tiles" << std::endl;
+    else g_out << "Decomposing the chunk with automatic tiling" << std::endl;
+    g_out << std::endl;
   }
   return chunk_neighbours;
 }
 
-std::vector<tile_info> clover_tile_decompose(global_variables &globals, int chunk_x_cells, int chunk_y_cells) {
+//  This decomposes the chunk into the tiles of the layout, see tiling.h.
+std::vector<tile_info> clover_tile_decompose(global_variables &globals, int chunk_x_cells, int chunk_y_cells,
+                                             const clover::tiling::layout &layout) {
 
   std::vector<tile_info> tiles(globals.config.tiles_per_chunk);
 
-  int chunk_mesh_ratio = (double)chunk_x_cells / (double)chunk_y_cells;
-
-  int tile_x = globals.config.tiles_per_chunk;
-  int tile_y = 1;
-
-  int split_found = 0; // Used to detect 1D decomposition
-  for (int t = 1; t <= globals.config.tiles_per_chunk; ++t) {
-    if (globals.config.tiles_per_chunk % t == 0) {
-      int factor_x = globals.config.tiles_per_chunk / (double)t;
-      int factor_y = t;
-      // Compare the factor ratio with the mesh ratio
-      if (factor_x / factor_y <= chunk_mesh_ratio) {
-        tile_y = t;
-        tile_x = globals.config.tiles_per_chunk / t;
-        split_found = 1;
-        break;
-      }
-    }
-  }
-
-  if (split_found == 0 || tile_y == globals.config.tiles_per_chunk) { // Prime number or 1D decomp detected
-    if (chunk_mesh_ratio >= 1.0) {
-      tile_x = globals.config.tiles_per_chunk;
-      tile_y = 1;
-    } else {
-      tile_x = 1;
-      tile_y = globals.config.tiles_per_chunk;
-    }
-  }
+  int tile_x = layout.tiles_x;
+  int tile_y = layout.tiles_y;
 
-  int chunk_delta_x = chunk_x_cells / tile_x;
-  int chunk_delta_y = chunk_y_cells / tile_y;
-  int chunk_mod_x = chunk_x_cells % tile_x;
-  int chunk_mod_y = chunk_y_cells % tile_y;
+  std::vector<int> widths = clover::tiling::split(chunk_x_cells, tile_x, layout.align);
+  std::vector<int> heights = clover::tiling::split(chunk_y_cells, tile_y, 1);
 
-  int add_x_prev = 0;
-  int add_y_prev = 0;
   int tile = 0; // Used to index globals.chunk.tiles array
+  int bottom = globals.chunk.bottom;
   for (int ty = 1; ty <= tile_y; ++ty) {
+    int top = bottom + heights[ty - 1] - 1;
+    int left = globals.chunk.left;
     for (int tx = 1; tx <= tile_x; ++tx) {
-      int add_x = 0;
-      int add_y = 0;
-      if (tx <= chunk_mod_x) add_x = 1;
-      if (ty <= chunk_mod_y) add_y = 1;
+      int right = left + widths[tx - 1] - 1;
 
-      int left = globals.chunk.left + (tx - 1) * chunk_delta_x + add_x_prev;
-      int right = left + chunk_delta_x - 1 + add_x;
-      int bottom = globals.chunk.bottom + (ty - 1) * chunk_delta_y + add_y_prev;
-      int top = bottom + chunk_delta_y - 1 + add_y;
+      // Neighbours index globals.chunk.tiles directly, so unlike the chunk neighbours these are zero based
+      tiles[tile].tile_neighbours[tile_left] = tile_x * (ty - 1) + tx - 2;
+      tiles[tile].tile_neighbours[tile_right] = tile_x * (ty - 1) + tx;
+      tiles[tile].tile_neighbours[tile_bottom] = tile_x * (ty - 2) + tx - 1;
+      tiles[tile].tile_neighbours[tile_top] = tile_x * (ty) + tx - 1;
 
-      tiles[tile].tile_neighbours[tile_left] = tile_x * (ty - 1) + tx - 1;
-      tiles[tile].tile_neighbours[tile_right] = tile_x * (ty - 1) + tx + 1;
-      tiles[tile].tile_neighbours[tile_bottom] = tile_x * (ty - 2) + tx;
-      tiles[tile].tile_neighbours[tile_top] = tile_x * (ty) + tx;
+      if (tx == 1) tiles[tile].tile_neighbours[tile_left] = external_tile;
+      if (tx == tile_x) tiles[tile].tile_neighbours[tile_right] = external_tile;
+      if (ty == 1) tiles[tile].tile_neighbours[tile_bottom] = external_tile;
+      if (ty == tile_y) tiles[tile].tile_neighbours[tile_top] = external_tile;
 
-      // initial set the external tile mask to 0 for each tile
+      // The external tile mask marks the tiles on the faces of the chunk
       for (int i = 0; i < 4; ++i) {
-        tiles[tile].external_tile_mask[i] = 0;
+        tiles[tile].external_tile_mask[i] = tiles[tile].tile_neighbours[i] == external_tile;
       }
 
-      if (tx == 1) {
-        tiles[tile].tile_neighbours[tile_left] = external_tile;
-        tiles[tile].external_tile_mask[tile_left] = 1;
-      }
-      if (tx == tile_x) {
-        tiles[tile].tile_neighbours[tile_right] = external_tile;
-        tiles[tile].external_tile_mask[tile_right] = 1;
-      }
-      if (ty == 1) {
-        tiles[tile].tile_neighbours[tile_bottom] = external_tile;
-        tiles[tile].external_tile_mask[tile_bottom] = 1;
-      }
-      if (ty == tile_y) {
-        tiles[tile].tile_neighbours[tile_top] = external_tile;
-        tiles[tile].external_tile_mask[tile_top] = 1;
-      }
-
-      if (tx <= chunk_mod_x) add_x_prev = add_x_prev + 1;
-
       tiles[tile].t_xmin = 1;
       tiles[tile].t_xmax = right - left + 1;
       tiles[tile].t_ymin = 1;
@@ -248,37 +223,114 @@ std::vector<tile_info> clover_tile_decompose(global_variables &globals, int chun
       tiles[tile].t_top = top;
       tiles[tile].t_bottom = bottom;
 
+      left = right + 1;
       tile = tile + 1;
     }
-    add_x_prev = 0;
-    if (ty <= chunk_mod_y) add_y_prev = add_y_prev + 1;
+    bottom = top + 1;
   }
   return tiles;
 }
 
 void clover_sum(double &value) {
   double total = value;
-  MPI_Reduce(&value, &total, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&value, &total, 1, MPI_DOUBLE, MPI_SUM, 0, g_comm);
   value = total;
 }
 
+void clover_sum(std::vector<double> &values) {
+  std::vector<double> total = values;
+  MPI_Reduce(values.data(), total.data(), static_cast<int>(values.size()), MPI_DOUBLE, MPI_SUM, 0, g_comm);
+  values = total;
+}
+
 void clover_min(double &value) {
   double minimum = value;
-  MPI_Allreduce(&value, &minimum, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(&value, &minimum, 1, MPI_DOUBLE, MPI_MIN, g_comm);
   value = minimum;
 }
 
+void clover_max(std::vector<double> &values) {
+  std::vector<double> maximum = values;
+  MPI_Reduce(values.data(), maximum.data(), static_cast<int>(values.size()), MPI_DOUBLE, MPI_MAX, 0, g_comm);
+  values = maximum;
+}
+
 void clover_allgather(double value, std::vector<double> &values) {
   values[0] = value; // Just to ensure it will work in serial
-  MPI_Allgather(&value, 1, MPI_DOUBLE, values.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+  MPI_Allgather(&value, 1, MPI_DOUBLE, values.data(), 1, MPI_DOUBLE, g_comm);
 }
 
 void clover_check_error(int &error) {
   int maximum = error;
-  MPI_Allreduce(&error, &maximum, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(&error, &maximum, 1, MPI_INT, MPI_MAX, g_comm);
   error = maximum;
 }
 
+// Applies f to every deck-derived scalar in the config, the order here defines the layout of the broadcast blob.
+// dumpDir, staging_buffer, halo_exchange, advection_kernel, stores, reproducible, fused_summary, arena, autotune
+// and number_of_chunks are set by each rank locally so they are not included.
+template <typename F> static void for_each_deck_scalar(global_config &config, F f) {
+  f(config.number_of_states);
+  f(config.tiles_per_chunk);
+  f(config.test_problem);
+  f(config.profiler_on);
+  f(config.end_time);
+  f(config.end_step);
+  f(config.dtinit);
+  f(config.dtmin);
+  f(config.dtmax);
+  f(config.dtrise);
+  f(config.dtu_safe);
+  f(config.dtv_safe);
+  f(config.dtc_safe);
+  f(config.dtdiv_safe);
+  f(config.dtc);
+  f(config.dtu);
+  f(config.dtv);
+  f(config.dtdiv);
+  f(config.visit_frequency);
+  f(config.summary_frequency);
+  f(config.warmup_steps);
+  f(config.grid);
+}
+
+//  Only the boss reads the input deck, everyone else receives the parsed config from here.
+//  The config is packed into a single byte blob so this costs one broadcast for the size and one for the payload,
+//  regardless of the number of states.
+void clover_broadcast_config(parallel_ &parallel, global_config &config) {
+  if (parallel.max_task == 1) return;
+
+  std::vector<char> blob;
+  if (parallel.boss) {
+    auto put = [&](const auto &value) {
+      static_assert(std::is_trivially_copyable_v<std::decay_t<decltype(value)>>);
+      const char *bytes = reinterpret_cast<const char *>(&value);
+      blob.insert(blob.end(), bytes, bytes + sizeof(value));
+    };
+    for_each_deck_scalar(config, put);
+    for (const state_type &state : config.states)
+      put(state);
+  }
+
+  int size = static_cast<int>(blob.size());
+  MPI_Bcast(&size, 1, MPI_INT, 0, g_comm);
+  blob.resize(size);
+  MPI_Bcast(blob.data(), size, MPI_BYTE, 0, g_comm);
+
+  if (!parallel.boss) {
+    size_t offset = 0;
+    auto get = [&](auto &value) {
+      static_assert(std::is_trivially_copyable_v<std::decay_t<decltype(value)>>);
+      std::memcpy(&value, blob.data() + offset, sizeof(value));
+      offset += sizeof(value);
+    };
+    for_each_deck_scalar(config, get);
+    config.states = std::vector<state_type>(config.number_of_states);
+    for (state_type &state : config.states)
+      get(state);
+  }
+}
+
 void clover_pack_left(global_variables &globals, clover::Buffer1D<double> &left_snd_buffer, int tile, const int fields[NUM_FIELDS],
                       int depth, int left_right_offset[NUM_FIELDS]) {
 
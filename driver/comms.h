@@ -21,6 +21,7 @@
 
 #include "context.h"
 #include "definitions.h"
+#include "tiling.h"
 
 #ifdef NO_MPI
   #include "mpi_shim.h"
@@ -35,6 +36,9 @@
 
 #endif
 
+// Communicator a run decomposes over: MPI_COMM_WORLD, or MPI_COMM_SELF for ensemble members (see clover_leaf.cpp)
+extern thread_local MPI_Comm g_comm;
+
 // Structure to hold MPI rank information
 struct parallel_ {
 
@@ -52,6 +56,7 @@ struct parallel_ {
 
   // Constructor, (replaces clover_init_comms())
   parallel_();
+  explicit parallel_(MPI_Comm comm);
 };
 
 void clover_abort();
@@ -59,13 +64,19 @@ void clover_barrier(global_variables &globals);
 void clover_barrier();
 
 std::array<int, 4> clover_decompose(const global_config &globals, parallel_ &parallel, int x_cells, int y_cells, int &left, int &right,
-                                    int &bottom, int &top);
-std::vector<tile_info> clover_tile_decompose(global_variables &globals, int chunk_x_cells, int chunk_y_cells);
+                                    int &bottom, int &top, std::vector<int> &chunk_tasks);
+std::vector<tile_info> clover_tile_decompose(global_variables &globals, int chunk_x_cells, int chunk_y_cells,
+                                             const clover::tiling::layout &layout);
 
 void clover_sum(double &value);
+// Element-wise sum over the ranks, only the boss receives the result
+void clover_sum(std::vector<double> &values);
 void clover_min(double &value);
+// Element-wise maximum over the ranks, only the boss receives the result
+void clover_max(std::vector<double> &values);
 void clover_allgather(double value, std::vector<double> &values);
 void clover_check_error(int &error);
+void clover_broadcast_config(parallel_ &parallel, global_config &config);
 
 void clover_pack_left(global_variables &globals, clover::Buffer1D<double> &, int tile, const int fields[NUM_FIELDS], int depth,
                       int left_right_offset[NUM_FIELDS]);
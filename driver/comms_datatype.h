@@ -0,0 +1,229 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+//  @brief Zero-copy MPI halo exchange
+//  @details Describes the halo strips of the tiles on each face of the task with MPI derived datatypes, so MPI reads
+//  and writes the field arrays in place instead of going through the pack kernels and the message buffers.
+//  The datatypes address the fields directly, so this is only included by models that keep their fields in host memory.
+//
+//  A face message carries every row (or column) of the chunk once, from depth cells before the chunk to depth
+//  cells past it, each taken from the tile that owns it. Neighbouring tiles on a face also hold each other's rows in
+//  their ghost cells; those are not sent but copied from the adjacent tile once the message has arrived.
+
+#include "comms.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#ifndef NO_MPI
+
+namespace clover::halo {
+
+// The storage of a field_parameter and its staggering
+struct field_ref {
+  clover::Buffer2D<double> *field;
+  int x_inc, y_inc;
+};
+
+inline field_ref field_of(field_type &f, int field) {
+  switch (field) {
+    case field_density0: return {&f.density0, 0, 0};
+    case field_density1: return {&f.density1, 0, 0};
+    case field_energy0: return {&f.energy0, 0, 0};
+    case field_energy1: return {&f.energy1, 0, 0};
+    case field_pressure: return {&f.pressure, 0, 0};
+    case field_viscosity: return {&f.viscosity, 0, 0};
+    case field_soundspeed: return {&f.soundspeed, 0, 0};
+    case field_xvel0: return {&f.xvel0, 1, 1};
+    case field_xvel1: return {&f.xvel1, 1, 1};
+    case field_yvel0: return {&f.yvel0, 1, 1};
+    case field_yvel1: return {&f.yvel1, 1, 1};
+    case field_vol_flux_x: return {&f.vol_flux_x, 1, 0};
+    case field_vol_flux_y: return {&f.vol_flux_y, 0, 1};
+    case field_mass_flux_x: return {&f.mass_flux_x, 1, 0};
+    case field_mass_flux_y: return {&f.mass_flux_y, 0, 1};
+    default: return {nullptr, 0, 0};
+  }
+}
+
+// Element (i, j) of a tile's field, in the tile's (Fortran) cell indices
+inline double &at(const tile_info &info, const field_ref &f, int i, int j) {
+  return (*f.field)(i - info.t_xmin + 2, j - info.t_ymin + 2);
+}
+
+// The tiles on a face of the task, ordered along the face
+inline std::vector<int> face_tiles(global_variables &globals, int face) {
+  std::vector<int> tiles;
+  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
+    if (globals.chunk.tiles[tile].info.external_tile_mask[face] == 1) tiles.push_back(tile);
+  }
+  bool vertical = face == chunk_left || face == chunk_right;
+  std::sort(tiles.begin(), tiles.end(), [&](int a, int b) {
+    const tile_info &ia = globals.chunk.tiles[a].info, &ib = globals.chunk.tiles[b].info;
+    return vertical ? ia.t_bottom < ib.t_bottom : ia.t_left < ib.t_left;
+  });
+  return tiles;
+}
+
+// First of the depth halo lines across the face, sent or received, matching the pack kernels
+inline int first_line(const tile_info &info, const field_ref &f, int face, bool send, int depth) {
+  switch (face) {
+    case chunk_left: return send ? info.t_xmin + f.x_inc : info.t_xmin - depth;
+    case chunk_right: return send ? info.t_xmax - depth + 1 : info.t_xmax + f.x_inc + 1;
+    case chunk_bottom: return send ? info.t_ymin + f.y_inc : info.t_ymin - depth;
+    case chunk_top: return send ? info.t_ymax - depth + 1 : info.t_ymax + f.y_inc + 1;
+    default: return 0;
+  }
+}
+
+// One strip of a field as (address, lines, line stride, cells, cell stride), a line runs across the face
+struct strip {
+  MPI_Aint address;
+  MPI_Aint lines, line_stride;
+  MPI_Aint cells, cell_stride;
+};
+
+// The cells [x0, x1] x [y0, y1] of a tile's field, as lines along y of cells along x if y_lines, or the reverse
+inline strip strip_of(const tile_info &info, const field_ref &f, int x0, int x1, int y0, int y1, bool y_lines) {
+  MPI_Aint x_stride = reinterpret_cast<char *>(&at(info, f, 1, 0)) - reinterpret_cast<char *>(&at(info, f, 0, 0));
+  MPI_Aint y_stride = reinterpret_cast<char *>(&at(info, f, 0, 1)) - reinterpret_cast<char *>(&at(info, f, 0, 0));
+  strip s{};
+  MPI_Get_address(&at(info, f, x0, y0), &s.address);
+  if (y_lines) {
+    s.lines = y1 - y0 + 1;
+    s.line_stride = y_stride;
+    s.cells = x1 - x0 + 1;
+    s.cell_stride = x_stride;
+  } else {
+    s.lines = x1 - x0 + 1;
+    s.line_stride = x_stride;
+    s.cells = y1 - y0 + 1;
+    s.cell_stride = y_stride;
+  }
+  return s;
+}
+
+// The strips of a face message, by field then by tile along the face
+inline std::vector<strip> face_strips(global_variables &globals, const int fields[NUM_FIELDS], int depth, int face, bool send) {
+  std::vector<int> tiles = face_tiles(globals, face);
+  bool vertical = face == chunk_left || face == chunk_right;
+  std::vector<strip> strips;
+  for (int field = 0; field < NUM_FIELDS; ++field) {
+    if (fields[field] != 1) continue;
+    for (size_t n = 0; n < tiles.size(); ++n) {
+      const tile_info &info = globals.chunk.tiles[tiles[n]].info;
+      field_ref f = field_of(globals.chunk.tiles[tiles[n]].field, field);
+      int across = first_line(info, f, face, send, depth);
+      // Only the first and last tile carry the cells beyond the chunk
+      int lo = vertical ? info.t_ymin : info.t_xmin;
+      int hi = vertical ? info.t_ymax : info.t_xmax;
+      if (n == 0) lo -= depth;
+      if (n == tiles.size() - 1) hi += (vertical ? f.y_inc : f.x_inc) + depth;
+      strips.push_back(vertical ? strip_of(info, f, across, across + depth - 1, lo, hi, true)
+                                : strip_of(info, f, lo, hi, across, across + depth - 1, false));
+    }
+  }
+  return strips;
+}
+
+// The committed datatype over the strips, built once per distinct layout as fields never move after start
+inline MPI_Datatype commit_type(const std::vector<strip> &strips) {
+  // Ranks may be threads of one process (see mpi_shim.h), so every thread keeps its own types
+  static thread_local std::map<std::vector<MPI_Aint>, MPI_Datatype> types;
+
+  std::vector<MPI_Aint> key;
+  for (const strip &s : strips)
+    key.insert(key.end(), {s.address, s.lines, s.line_stride, s.cells, s.cell_stride});
+  if (auto found = types.find(key); found != types.end()) return found->second;
+
+  std::vector<MPI_Datatype> blocks(strips.size());
+  std::vector<MPI_Aint> displacements(strips.size());
+  std::vector<int> lengths(strips.size(), 1);
+  for (size_t i = 0; i < strips.size(); ++i) {
+    MPI_Datatype line;
+    MPI_Type_create_hvector(int(strips[i].cells), 1, strips[i].cell_stride, MPI_DOUBLE, &line);
+    MPI_Type_create_hvector(int(strips[i].lines), 1, strips[i].line_stride, line, &blocks[i]);
+    MPI_Type_free(&line);
+    displacements[i] = strips[i].address;
+  }
+  MPI_Datatype type;
+  MPI_Type_create_struct(int(strips.size()), lengths.data(), displacements.data(), blocks.data(), &type);
+  MPI_Type_commit(&type);
+  for (MPI_Datatype &block : blocks)
+    MPI_Type_free(&block);
+  return types[key] = type;
+}
+
+inline MPI_Datatype face_type(global_variables &globals, const int fields[NUM_FIELDS], int depth, int face, bool send) {
+  return commit_type(face_strips(globals, fields, depth, face, send));
+}
+
+// Copies the received ghost lines shared between neighbouring tiles on a face
+inline void fill_face_corners(global_variables &globals, const int fields[NUM_FIELDS], int depth, int face) {
+  std::vector<int> tiles = face_tiles(globals, face);
+  bool vertical = face == chunk_left || face == chunk_right;
+  for (int field = 0; field < NUM_FIELDS; ++field) {
+    if (fields[field] != 1) continue;
+    for (size_t n = 1; n < tiles.size(); ++n) {
+      const tile_info &lower = globals.chunk.tiles[tiles[n - 1]].info, &upper = globals.chunk.tiles[tiles[n]].info;
+      field_ref lf = field_of(globals.chunk.tiles[tiles[n - 1]].field, field);
+      field_ref uf = field_of(globals.chunk.tiles[tiles[n]].field, field);
+      int l_across = first_line(lower, lf, face, false, depth), u_across = first_line(upper, uf, face, false, depth);
+      int inc = vertical ? lf.y_inc : lf.x_inc;
+      int l_max = vertical ? lower.t_ymax : lower.t_xmax, u_min = vertical ? upper.t_ymin : upper.t_xmin;
+      auto l_at = [&](int a, int k) -> double & { return vertical ? at(lower, lf, a, k) : at(lower, lf, k, a); };
+      auto u_at = [&](int a, int k) -> double & { return vertical ? at(upper, uf, a, k) : at(upper, uf, k, a); };
+      for (int a = 0; a < depth; ++a) {
+        for (int k = 1; k <= depth; ++k)
+          u_at(u_across + a, u_min - k) = l_at(l_across + a, l_max + 1 - k);
+        for (int k = 1; k <= inc + depth; ++k)
+          l_at(l_across + a, l_max + k) = u_at(u_across + a, u_min + k - 1);
+      }
+    }
+  }
+}
+
+// Same message pairing and tags as the pack path in clover_exchange, left/right first so that the bottom/top messages
+// carry up to date corners
+inline void exchange(global_variables &globals, const int fields[NUM_FIELDS], int depth) {
+  constexpr int send_tag[4] = {1, 2, 3, 4};
+  constexpr int recv_tag[4] = {2, 1, 4, 3};
+  for (auto direction : {std::array<int, 2>{chunk_left, chunk_right}, std::array<int, 2>{chunk_bottom, chunk_top}}) {
+    MPI_Request request[4] = {0};
+    int message_count = 0;
+    for (int face : direction) {
+      if (globals.chunk.chunk_neighbours[face] == external_face) continue;
+      int task = globals.chunk.neighbour_task(face);
+      MPI_Isend(MPI_BOTTOM, 1, face_type(globals, fields, depth, face, true), task, send_tag[face], g_comm,
+                &request[message_count++]);
+      MPI_Irecv(MPI_BOTTOM, 1, face_type(globals, fields, depth, face, false), task, recv_tag[face], g_comm,
+                &request[message_count++]);
+    }
+    MPI_Waitall(message_count, request, MPI_STATUSES_IGNORE);
+    for (int face : direction) {
+      if (globals.chunk.chunk_neighbours[face] != external_face) fill_face_corners(globals, fields, depth, face);
+    }
+  }
+}
+
+} // namespace clover::halo
+
+#endif
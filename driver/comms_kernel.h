@@ -27,6 +27,9 @@ void clover_allocate_buffers(global_variables &globals, parallel_ &parallel);
 
 void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], int depth);
 
+// Whether this model's clover_exchange implements the given halo exchange, pack is always available
+bool clover_exchange_supported(halo_exchange_type type);
+
 void clover_send_recv_message_left(global_variables &globals, clover::StagingBuffer1D<double> left_snd_buffer,
                                    clover::StagingBuffer1D<double> left_rcv_buffer, int total_size, int tag_send, int tag_recv,
                                    MPI_Request &req_send, MPI_Request &req_recv);
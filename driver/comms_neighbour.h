@@ -0,0 +1,124 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+//  @brief Halo exchange as a single neighbourhood collective
+//  @details Connects each task to the up to eight tasks around its block, across the faces and the corners, in a
+//  distributed graph communicator and moves the whole halo with one MPI_Neighbor_alltoallw per update_halo.
+//  The corner tasks send their corner cells directly, where the point-to-point path needs a second phase to
+//  forward them through the face neighbours. The messages are the derived datatypes of comms_datatype.h, so
+//  nothing is packed either.
+
+#include "comms_datatype.h"
+#include <memory>
+
+#ifndef NO_MPI
+
+namespace clover::halo {
+
+struct neighbour_graph {
+  MPI_Comm comm = MPI_COMM_NULL;
+  // Direction (dx, dy) of each neighbour in graph order
+  std::vector<std::array<int, 2>> directions;
+
+  neighbour_graph() = default;
+  neighbour_graph(const neighbour_graph &) = delete;
+  neighbour_graph &operator=(const neighbour_graph &) = delete;
+  ~neighbour_graph() {
+    // Globals outlive MPI_Finalize, which already released the communicator by then
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized && comm != MPI_COMM_NULL) MPI_Comm_free(&comm);
+  }
+};
+
+// Collective over g_comm
+inline std::shared_ptr<neighbour_graph> create_neighbour_graph(global_variables &globals) {
+  auto graph = std::make_shared<neighbour_graph>();
+  int task = globals.chunk.task;
+  auto across = [&](int face) { return globals.chunk.chunk_neighbours[face] == external_face ? -1 : globals.chunk.neighbour_task(face); };
+
+  std::vector<int> ranks;
+  for (int dy = -1; dy <= 1; ++dy) {
+    for (int dx = -1; dx <= 1; ++dx) {
+      if (dx == 0 && dy == 0) continue;
+      int x = dx == 0 ? task : across(dx < 0 ? chunk_left : chunk_right);
+      int y = dy == 0 ? task : across(dy < 0 ? chunk_bottom : chunk_top);
+      if (x < 0 || y < 0) continue;
+      // Tasks are numbered row by row over the task grid, so a corner is offset by both of its face offsets
+      ranks.push_back(x + y - task);
+      graph->directions.push_back({dx, dy});
+    }
+  }
+  MPI_Dist_graph_create_adjacent(g_comm, int(ranks.size()), ranks.data(), MPI_UNWEIGHTED, int(ranks.size()), ranks.data(),
+                                 MPI_UNWEIGHTED, MPI_INFO_NULL, 0, &graph->comm);
+  return graph;
+}
+
+// The strips of the message to or from the neighbour in direction (dx, dy): the depth lines next to the face,
+// restricted to the block, or the depth by depth block at a corner
+inline std::vector<strip> neighbour_strips(global_variables &globals, const int fields[NUM_FIELDS], int depth, int dx, int dy,
+                                           bool send) {
+  int x_face = dx < 0 ? chunk_left : chunk_right, y_face = dy < 0 ? chunk_bottom : chunk_top;
+  std::vector<int> tiles = face_tiles(globals, dx != 0 ? x_face : y_face);
+  if (dx != 0 && dy != 0) {
+    tiles.erase(std::remove_if(tiles.begin(), tiles.end(),
+                               [&](int tile) { return globals.chunk.tiles[tile].info.external_tile_mask[y_face] != 1; }),
+                tiles.end());
+  }
+
+  std::vector<strip> strips;
+  for (int field = 0; field < NUM_FIELDS; ++field) {
+    if (fields[field] != 1) continue;
+    for (size_t n = 0; n < tiles.size(); ++n) {
+      const tile_info &info = globals.chunk.tiles[tiles[n]].info;
+      field_ref f = field_of(globals.chunk.tiles[tiles[n]].field, field);
+      bool last = n == tiles.size() - 1;
+      int x0 = dx != 0 ? first_line(info, f, x_face, send, depth) : info.t_xmin;
+      int x1 = dx != 0 ? x0 + depth - 1 : info.t_xmax + (last ? f.x_inc : 0);
+      int y0 = dy != 0 ? first_line(info, f, y_face, send, depth) : info.t_ymin;
+      int y1 = dy != 0 ? y0 + depth - 1 : info.t_ymax + (last ? f.y_inc : 0);
+      strips.push_back(strip_of(info, f, x0, x1, y0, y1, dx != 0));
+    }
+  }
+  return strips;
+}
+
+inline void exchange_neighbour(global_variables &globals, neighbour_graph &graph, const int fields[NUM_FIELDS], int depth) {
+  size_t count = graph.directions.size();
+  std::vector<int> counts(count, 1);
+  std::vector<MPI_Aint> displacements(count, 0);
+  std::vector<MPI_Datatype> send_types(count), recv_types(count);
+  for (size_t i = 0; i < count; ++i) {
+    auto [dx, dy] = graph.directions[i];
+    send_types[i] = commit_type(neighbour_strips(globals, fields, depth, dx, dy, true));
+    recv_types[i] = commit_type(neighbour_strips(globals, fields, depth, dx, dy, false));
+  }
+  MPI_Neighbor_alltoallw(MPI_BOTTOM, counts.data(), displacements.data(), send_types.data(), //
+                         MPI_BOTTOM, counts.data(), displacements.data(), recv_types.data(), graph.comm);
+
+  for (int face = 0; face < 4; ++face) {
+    if (globals.chunk.chunk_neighbours[face] != external_face) fill_face_corners(globals, fields, depth, face);
+  }
+}
+
+} // namespace clover::halo
+
+#endif
@@ -0,0 +1,208 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+//  @brief Intra-node halo exchange through an MPI-3 shared memory window
+//  @details Every rank on a node packs its outgoing face messages into a window allocated with
+//  MPI_Win_allocate_shared. A neighbour on the same node unpacks straight out of that window once the node has
+//  synchronised, so the message is never copied by MPI. Neighbours on other nodes are sent the same memory with
+//  MPI_Isend as usual.
+//
+//  Each face has two slots used on alternate exchanges. A rank may then pack the next message while a slower
+//  neighbour still unpacks the previous one, and one node barrier per direction is enough. Like the pack path,
+//  this assumes every field lives in host memory.
+
+#include "comms.h"
+#include <array>
+#include <cstdlib>
+#include <memory>
+
+#ifndef NO_MPI
+
+namespace clover::halo {
+
+// A Buffer1D over window memory for the pack kernels, the window owns the storage so the view hands back the
+// buffer's own allocation before it is destroyed
+struct window_view {
+  clover::Buffer1D<double> buffer;
+  double *own;
+  window_view(clover::context &ctx, double *data, size_t size) : buffer(ctx, 0), own(buffer.data) {
+    buffer.data = data;
+    buffer.size = size;
+  }
+  window_view(const window_view &) = delete;
+  window_view &operator=(const window_view &) = delete;
+  ~window_view() {
+    buffer.data = own;
+    buffer.size = 0;
+  }
+};
+
+struct shared_window {
+  MPI_Comm node = MPI_COMM_NULL;
+  // One window for the left/right slots and one for bottom/top, so slot offsets only depend on the extent shared with
+  // the neighbour across the face
+  std::array<MPI_Win, 2> win{MPI_WIN_NULL, MPI_WIN_NULL};
+  // Rank within the node of the neighbour across each face, MPI_UNDEFINED if external or on another node
+  std::array<int, 4> node_rank{};
+  // Outgoing slots of this rank and the neighbours' slots facing it, by parity then face
+  std::array<std::array<std::unique_ptr<window_view>, 4>, 2> snd, peer;
+  // Messages from neighbours on other nodes
+  std::array<std::unique_ptr<clover::Buffer1D<double>>, 4> rcv;
+  int parity = 0;
+
+  shared_window() = default;
+  shared_window(const shared_window &) = delete;
+  shared_window &operator=(const shared_window &) = delete;
+  ~shared_window() {
+    // Globals outlive MPI_Finalize, which already released the window by then
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (finalized) return;
+    for (MPI_Win &w : win) {
+      if (w == MPI_WIN_NULL) continue;
+      MPI_Win_unlock_all(w);
+      MPI_Win_free(&w);
+    }
+    if (node != MPI_COMM_NULL) MPI_Comm_free(&node);
+  }
+};
+
+// The window holding a face's slots
+inline int window_of(int face) { return face == chunk_left || face == chunk_right ? 0 : 1; }
+
+// Size in doubles of a slot on the face, enough for every field at the deepest (2 cell) halo
+inline size_t slot_size(const global_variables &globals, int face) {
+  return size_t(NUM_FIELDS) * 2 * ((window_of(face) == 0 ? globals.chunk.y_max : globals.chunk.x_max) + 5);
+}
+
+// Offset in doubles of a slot within a rank's part of the face's window
+inline size_t slot_offset(const global_variables &globals, int parity, int face) {
+  return size_t((face % 2) * 2 + parity) * slot_size(globals, face);
+}
+
+// Collective over g_comm
+inline std::shared_ptr<shared_window> allocate_shared(global_variables &globals) {
+  auto w = std::make_shared<shared_window>();
+  MPI_Comm_split_type(g_comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &w->node);
+
+  MPI_Group world_group, node_group;
+  MPI_Comm_group(g_comm, &world_group);
+  MPI_Comm_group(w->node, &node_group);
+  for (int face = 0; face < 4; ++face) {
+    w->node_rank[face] = MPI_UNDEFINED;
+    if (globals.chunk.chunk_neighbours[face] == external_face) continue;
+    int task = globals.chunk.neighbour_task(face);
+    MPI_Group_translate_ranks(world_group, 1, &task, node_group, &w->node_rank[face]);
+  }
+  MPI_Group_free(&node_group);
+  MPI_Group_free(&world_group);
+
+  std::array<double *, 2> base{};
+  for (int window = 0; window < 2; ++window) {
+    size_t size = 4 * slot_size(globals, window == 0 ? chunk_left : chunk_bottom);
+    MPI_Win_allocate_shared(MPI_Aint(size * sizeof(double)), sizeof(double), MPI_INFO_NULL, w->node, &base[window], &w->win[window]);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, w->win[window]);
+  }
+
+  constexpr int opposite[4] = {chunk_right, chunk_left, chunk_top, chunk_bottom};
+  for (int face = 0; face < 4; ++face) {
+    size_t size = slot_size(globals, face);
+    double *peer_base = nullptr;
+    if (w->node_rank[face] != MPI_UNDEFINED) {
+      MPI_Aint peer_size;
+      int disp_unit;
+      MPI_Win_shared_query(w->win[window_of(face)], w->node_rank[face], &peer_size, &disp_unit, &peer_base);
+    }
+    for (int parity = 0; parity < 2; ++parity) {
+      double *own = base[window_of(face)] + slot_offset(globals, parity, face);
+      w->snd[parity][face] = std::make_unique<window_view>(globals.context, own, size);
+      if (peer_base) {
+        double *peer = peer_base + slot_offset(globals, parity, opposite[face]);
+        w->peer[parity][face] = std::make_unique<window_view>(globals.context, peer, size);
+      }
+    }
+    w->rcv[face] = std::make_unique<clover::Buffer1D<double>>(globals.context, size);
+  }
+  return w;
+}
+
+// Same message layout and tags as the pack path in clover_exchange, left/right first so that the bottom/top messages
+// carry up to date corners
+inline void exchange_shared(global_variables &globals, shared_window &w, const int fields[NUM_FIELDS], int depth) {
+  using pack_fn = void (*)(global_variables &, clover::Buffer1D<double> &, int, const int *, int, int *);
+  using unpack_fn = void (*)(global_variables &, clover::Buffer1D<double> &, const int *, int, int, int *);
+  constexpr pack_fn pack[4] = {clover_pack_left, clover_pack_right, clover_pack_bottom, clover_pack_top};
+  constexpr unpack_fn unpack[4] = {clover_unpack_left, clover_unpack_right, clover_unpack_bottom, clover_unpack_top};
+  constexpr int send_tag[4] = {1, 2, 3, 4};
+  constexpr int recv_tag[4] = {2, 1, 4, 3};
+
+  int left_right_offset[NUM_FIELDS];
+  int bottom_top_offset[NUM_FIELDS];
+  int end_pack_index_left_right = 0;
+  int end_pack_index_bottom_top = 0;
+  for (int field = 0; field < NUM_FIELDS; ++field) {
+    if (fields[field] == 1) {
+      left_right_offset[field] = end_pack_index_left_right;
+      bottom_top_offset[field] = end_pack_index_bottom_top;
+      end_pack_index_left_right += depth * (globals.chunk.y_max + 5);
+      end_pack_index_bottom_top += depth * (globals.chunk.x_max + 5);
+    }
+  }
+
+  w.parity ^= 1;
+  for (auto direction : {std::array<int, 2>{chunk_left, chunk_right}, std::array<int, 2>{chunk_bottom, chunk_top}}) {
+    bool vertical = direction[0] == chunk_left;
+    int *offset = vertical ? left_right_offset : bottom_top_offset;
+    int total_size = vertical ? end_pack_index_left_right : end_pack_index_bottom_top;
+
+    MPI_Request request[4] = {0};
+    int message_count = 0;
+    for (int face : direction) {
+      if (globals.chunk.chunk_neighbours[face] == external_face) continue;
+      clover::Buffer1D<double> &snd = w.snd[w.parity][face]->buffer;
+      for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
+        if (globals.chunk.tiles[tile].info.external_tile_mask[face] == 1) pack[face](globals, snd, tile, fields, depth, offset);
+      }
+      if (w.node_rank[face] != MPI_UNDEFINED) continue;
+      int task = globals.chunk.neighbour_task(face);
+      MPI_Isend(snd.data, total_size, MPI_DOUBLE, task, send_tag[face], g_comm, &request[message_count++]);
+      MPI_Irecv(w.rcv[face]->data, total_size, MPI_DOUBLE, task, recv_tag[face], g_comm, &request[message_count++]);
+    }
+
+    // Every rank on the node takes part, whether or not it has a neighbour there
+    MPI_Win_sync(w.win[window_of(direction[0])]);
+    MPI_Barrier(w.node);
+    MPI_Win_sync(w.win[window_of(direction[0])]);
+    MPI_Waitall(message_count, request, MPI_STATUSES_IGNORE);
+
+    for (int face : direction) {
+      if (globals.chunk.chunk_neighbours[face] == external_face) continue;
+      clover::Buffer1D<double> &rcv = w.node_rank[face] != MPI_UNDEFINED ? w.peer[w.parity][face]->buffer : *w.rcv[face];
+      for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
+        if (globals.chunk.tiles[tile].info.external_tile_mask[face] == 1) unpack[face](globals, rcv, fields, tile, depth, offset);
+      }
+    }
+  }
+}
+
+} // namespace clover::halo
+
+#endif
@@ -1,55 +1,81 @@
 
 #include "definitions.h"
+#include "arena.h"
 
-field_type::field_type(const size_t xrange, const size_t yrange, clover::context &ctx)
-    //                                               //    --timestep--              --pdV--                   --pdV--
-    : density0(ctx, xrange, yrange),        // [ idg           _ ]    [ pdv idg revert ]  accel  [ pdv idg revert ]      |          reset
-      density1(ctx, xrange, yrange),        // [ idg           _ ]    [ pdv idg revert ]         [ pdv idg revert ]      | adv_mom  reset
-      energy0(ctx, xrange, yrange),         // [ idg viscosity _ ]    [ pdv idg revert ]         [ pdv idg revert ]      |          reset
-      energy1(ctx, xrange, yrange),         // [ idg           _ ]    [ pdv idg revert ]         [ pdv idg revert ]      |          reset
-      pressure(ctx, xrange, yrange),        // [ idg viscosity _ ]    [ pdv idg        ]  accel  [ pdv idg        ]      |
-      viscosity(ctx, xrange, yrange),       // [               _ ]    [ pdv            ]  accel  [ pdv            ]      |
-      soundspeed(ctx, xrange, yrange),      // [ idg           _ ]    [     idg        ]         [     idg        ]      |
-      xvel0(ctx, xrange + 1, yrange + 1),   // [     viscosity _ ]    [ pdv            ]  accel  [ pdv            ] flux | reset
-      xvel1(ctx, xrange + 1, yrange + 1),   // [     viscosity _ ]    [ pdv            ]  accel  [ pdv            ] flux | adv_mom  reset
-      yvel0(ctx, xrange + 1, yrange + 1),   // [               _ ]    [ pdv            ]  accel  [ pdv            ] flux | reset
-      yvel1(ctx, xrange + 1, yrange + 1),   // [               _ ]    [ pdv            ]  accel  [ pdv            ] flux | adv_mom  reset
-      vol_flux_x(ctx, xrange + 1, yrange),  // [               _ ]    [                ]         [                ] flux | adv_mom
-      mass_flux_x(ctx, xrange + 1, yrange), // [               _ ]    [                ]         [                ]      | adv_mom
-      vol_flux_y(ctx, xrange, yrange + 1),  // [               _ ]    [                ]         [                ] flux | adv_mom
-      mass_flux_y(ctx, xrange, yrange + 1), // [               _ ]    [                ]         [                ]      | adv_mom
-      work_array1(ctx, xrange + 1, yrange + 1), // [               _ ]    [ pdv            ]         [ pdv            ]      | adv_mom
-      work_array2(ctx, xrange + 1, yrange + 1), // [               _ ]    [                ]         [                ]      | adv_mom
-      work_array3(ctx, xrange + 1, yrange + 1), // [               _ ]    [                ]         [                ]      | adv_mom
-      work_array4(ctx, xrange + 1, yrange + 1), // [               _ ]    [                ]         [                ]      | adv_mom
-      work_array5(ctx, xrange + 1, yrange + 1), // [               _ ]    [                ]         [                ]      | adv_mom
-      work_array6(ctx, xrange + 1, yrange + 1), // [               _ ]    [                ]         [                ]      | adv_mom
-      work_array7(ctx, xrange + 1, yrange + 1), // [               _ ]    [                ]         [                ]      |
-      cellx(ctx, xrange),                       // [               _ ]    [                ]         [                ]      |
-      celldx(ctx, xrange),                      // [     viscosity _ ]    [                ]         [                ]      | adv_mom
-      celly(ctx, yrange),                       // [               _ ]    [                ]         [                ]      |
-      celldy(ctx, yrange),                      // [     viscosity _ ]    [                ]         [                ]      | adv_mom
-      vertexx(ctx, xrange + 1),                 // [               _ ]    [                ]         [                ]      |
-      vertexdx(ctx, xrange + 1),                // [               _ ]    [                ]         [                ]      |
-      vertexy(ctx, yrange + 1),                 // [               _ ]    [                ]         [                ]      |
-      vertexdy(ctx, yrange + 1),                // [               _ ]    [                ]         [                ]      |
-      volume(ctx, xrange, yrange),              // [               _ ]    [ pdv            ]  accel  [ pdv            ]      | adv_mom
-      xarea(ctx, xrange + 1, yrange),           // [               _ ]    [ pdv            ]  accel  [ pdv            ] flux |
-      yarea(ctx, xrange, yrange + 1),           // [               _ ]    [ pdv            ]  accel  [ pdv            ] flux |
+#include <type_traits>
+
+using D1 = clover::Buffer1D<double>;
+using D2 = clover::Buffer2D<double>;
+namespace a = clover::arena;
+
+// Host models whose buffers take outside storage get their arrays from the tile's arena
+bool field_arena_supported() { return std::is_constructible_v<D2, clover::context &, size_t, size_t, double *>; }
+
+static std::shared_ptr<a::block> make_arena(arena_type layout, size_t xrange, size_t yrange) {
+  if (layout == arena_type::off || !field_arena_supported()) return nullptr;
+  return std::make_shared<a::block>(layout, xrange, yrange);
+}
+
+// The array's storage in the arena, or an allocation of its own
+template <typename B, typename... N>
+static B carve(clover::context &ctx, [[maybe_unused]] const std::shared_ptr<a::block> &arena, [[maybe_unused]] a::array array, N... n) {
+  if constexpr (std::is_constructible_v<B, clover::context &, N..., double *>) {
+    if (arena) return B(ctx, n..., arena->carve(array, (size_t(n) * ...)));
+  }
+  return B(ctx, n...);
+}
+
+field_type::field_type(const size_t xrange, const size_t yrange, clover::context &ctx, arena_type layout)
+    //                                                                            //    --timestep--              --pdV--                   --pdV--
+    : arena(make_arena(layout, xrange, yrange)),
+      density0(carve<D2>(ctx, arena, a::density0, xrange, yrange)),               // [ idg           _ ]    [ pdv idg revert ]  accel  [ pdv idg revert ]      |          reset
+      density1(carve<D2>(ctx, arena, a::density1, xrange, yrange)),               // [ idg           _ ]    [ pdv idg revert ]         [ pdv idg revert ]      | adv_mom  reset
+      energy0(carve<D2>(ctx, arena, a::energy0, xrange, yrange)),                 // [ idg viscosity _ ]    [ pdv idg revert ]         [ pdv idg revert ]      |          reset
+      energy1(carve<D2>(ctx, arena, a::energy1, xrange, yrange)),                 // [ idg           _ ]    [ pdv idg revert ]         [ pdv idg revert ]      |          reset
+      pressure(carve<D2>(ctx, arena, a::pressure, xrange, yrange)),               // [ idg viscosity _ ]    [ pdv idg        ]  accel  [ pdv idg        ]      |
+      viscosity(carve<D2>(ctx, arena, a::viscosity, xrange, yrange)),             // [               _ ]    [ pdv            ]  accel  [ pdv            ]      |
+      soundspeed(carve<D2>(ctx, arena, a::soundspeed, xrange, yrange)),           // [ idg           _ ]    [     idg        ]         [     idg        ]      |
+      xvel0(carve<D2>(ctx, arena, a::xvel0, xrange + 1, yrange + 1)),             // [     viscosity _ ]    [ pdv            ]  accel  [ pdv            ] flux | reset
+      xvel1(carve<D2>(ctx, arena, a::xvel1, xrange + 1, yrange + 1)),             // [     viscosity _ ]    [ pdv            ]  accel  [ pdv            ] flux | adv_mom  reset
+      yvel0(carve<D2>(ctx, arena, a::yvel0, xrange + 1, yrange + 1)),             // [               _ ]    [ pdv            ]  accel  [ pdv            ] flux | reset
+      yvel1(carve<D2>(ctx, arena, a::yvel1, xrange + 1, yrange + 1)),             // [               _ ]    [ pdv            ]  accel  [ pdv            ] flux | adv_mom  reset
+      vol_flux_x(carve<D2>(ctx, arena, a::vol_flux_x, xrange + 1, yrange)),       // [               _ ]    [                ]         [                ] flux | adv_mom
+      mass_flux_x(carve<D2>(ctx, arena, a::mass_flux_x, xrange + 1, yrange)),     // [               _ ]    [                ]         [                ]      | adv_mom
+      vol_flux_y(carve<D2>(ctx, arena, a::vol_flux_y, xrange, yrange + 1)),       // [               _ ]    [                ]         [                ] flux | adv_mom
+      mass_flux_y(carve<D2>(ctx, arena, a::mass_flux_y, xrange, yrange + 1)),     // [               _ ]    [                ]         [                ]      | adv_mom
+      work_array1(carve<D2>(ctx, arena, a::work_array1, xrange + 1, yrange + 1)), // [               _ ]    [ pdv            ]         [ pdv            ]      | adv_mom
+      work_array2(carve<D2>(ctx, arena, a::work_array2, xrange + 1, yrange + 1)), // [               _ ]    [                ]         [                ]      | adv_mom
+      work_array3(carve<D2>(ctx, arena, a::work_array3, xrange + 1, yrange + 1)), // [               _ ]    [                ]         [                ]      | adv_mom
+      work_array4(carve<D2>(ctx, arena, a::work_array4, xrange + 1, yrange + 1)), // [               _ ]    [                ]         [                ]      | adv_mom
+      work_array5(carve<D2>(ctx, arena, a::work_array5, xrange + 1, yrange + 1)), // [               _ ]    [                ]         [                ]      | adv_mom
+      work_array6(carve<D2>(ctx, arena, a::work_array6, xrange + 1, yrange + 1)), // [               _ ]    [                ]         [                ]      | adv_mom
+      work_array7(carve<D2>(ctx, arena, a::work_array7, xrange + 1, yrange + 1)), // [               _ ]    [                ]         [                ]      |
+      cellx(carve<D1>(ctx, arena, a::cellx, xrange)),                             // [               _ ]    [                ]         [                ]      |
+      celldx(carve<D1>(ctx, arena, a::celldx, xrange)),                           // [     viscosity _ ]    [                ]         [                ]      | adv_mom
+      celly(carve<D1>(ctx, arena, a::celly, yrange)),                             // [               _ ]    [                ]         [                ]      |
+      celldy(carve<D1>(ctx, arena, a::celldy, yrange)),                           // [     viscosity _ ]    [                ]         [                ]      | adv_mom
+      vertexx(carve<D1>(ctx, arena, a::vertexx, xrange + 1)),                     // [               _ ]    [                ]         [                ]      |
+      vertexdx(carve<D1>(ctx, arena, a::vertexdx, xrange + 1)),                   // [               _ ]    [                ]         [                ]      |
+      vertexy(carve<D1>(ctx, arena, a::vertexy, yrange + 1)),                     // [               _ ]    [                ]         [                ]      |
+      vertexdy(carve<D1>(ctx, arena, a::vertexdy, yrange + 1)),                   // [               _ ]    [                ]         [                ]      |
+      volume(carve<D2>(ctx, arena, a::volume, xrange, yrange)),                   // [               _ ]    [ pdv            ]  accel  [ pdv            ]      | adv_mom
+      xarea(carve<D2>(ctx, arena, a::xarea, xrange + 1, yrange)),                 // [               _ ]    [ pdv            ]  accel  [ pdv            ] flux |
+      yarea(carve<D2>(ctx, arena, a::yarea, xrange, yrange + 1)),                 // [               _ ]    [ pdv            ]  accel  [ pdv            ] flux |
       base_stride(xrange), vels_wk_stride(xrange + 1), flux_x_stride(xrange + 1), flux_y_stride(xrange)
 
 {}
 
-chunk_type::chunk_type(const std::array<int, 4> &chunkNeighbours, const int task, //
+chunk_type::chunk_type(const std::array<int, 4> &chunkNeighbours, const std::vector<int> &chunkTasks, const int task, //
                        const int xMin, const int yMin, const int xMax,
                        const int yMax,                                                                                   //
                        const int left, const int right, const int bottom, const int top,                                 //
                        const int leftBoundary, const int rightBoundary, const int bottomBoundary, const int topBoundary, //
                        const int tiles_per_chunk)
-    : chunk_neighbours(chunkNeighbours), task(task),      //
+    : chunk_neighbours(chunkNeighbours), chunk_tasks(chunkTasks), task(task), //
       x_min(xMin), y_min(yMin), x_max(xMax), y_max(yMax), //
       left(left), right(right), bottom(bottom), top(top), //
       left_boundary(leftBoundary), right_boundary(rightBoundary), bottom_boundary(bottomBoundary), top_boundary(topBoundary) {}
 global_variables::global_variables(const global_config &config, clover::context queue, chunk_type chunk)
     : config(config), context(std::move(queue)), chunk(std::move(chunk)), dt(config.dtinit), dtold(config.dtinit),
-      profiler_on(config.profiler_on) {}
+      profiler_on(config.profiler_on), halo_exchange(config.halo_exchange), advection_kernel(config.advection_kernel),
+      stores(config.stores) {}
@@ -22,6 +22,7 @@
 #include "context.h"
 
 #include <array>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -47,6 +48,10 @@ template <typename T> struct Buffer1D;
 struct chunk_context;
 struct context;
 
+namespace arena {
+class block;
+}
+
 // template <typename T> Buffer1D<T> alloc(size_t x);
 // template <typename T> Buffer2D<T> alloc(size_t x, size_t y);
 
@@ -55,7 +60,7 @@ struct context;
 enum geometry_type { g_rect = 1, g_circ = 2, g_point = 3 };
 // In the Fortran version these are 1,2,3,4,-1, but they are used directly to index an array in this version
 enum chunk_neighbour_type { chunk_left = 0, chunk_right = 1, chunk_bottom = 2, chunk_top = 3, external_face = -1 };
-enum tile_neighbour_type { tile_left = 0, tile_right = 1, tile_bottom = 3, tile_top = 3, external_tile = -1 };
+enum tile_neighbour_type { tile_left = 0, tile_right = 1, tile_bottom = 2, tile_top = 3, external_tile = -1 };
 
 // Again, start at 0 as used for indexing an array of length NUM_FIELDS
 enum field_parameter {
@@ -78,6 +83,20 @@ enum field_parameter {
 
 enum data_parameter { cell_data = 1, vertex_data = 2, x_face_data = 3, y_face_data = 4 };
 enum dir_parameter { g_xdir = 1, g_ydir = 2 };
+// How the MPI halo exchange moves data: through packed buffers, in place with MPI derived datatypes, through a
+// node-shared window for neighbours on the same node, or as one neighbourhood collective
+enum class halo_exchange_type { pack, datatype, shared, neighbour };
+
+// scalar is the reference van Leer flux loops, simd the branch free vector variant (see simd.h) where a model has one
+enum class advection_kernel_type { scalar, simd };
+
+// How the write-only outputs of ideal gas, reset field and the advection volumes are stored: normal stores, or
+// non-temporal ones that skip the read for ownership (see simd::stream) where a model has them
+enum class store_type { normal, streaming };
+
+// How a tile's field arrays are allocated: each on its own, carved from one block, or carved from one block with the
+// work arrays sharing the storage of fields that are dead while they are live (see arena.h)
+enum class arena_type { off, packed, aliased };
 
 struct state_type {
 
@@ -129,6 +148,8 @@ struct profiler_type {
 
 struct field_type {
 
+  std::shared_ptr<clover::arena::block> arena; // The storage of the arrays below, null without an arena
+
   clover::Buffer2D<double> density0;
   clover::Buffer2D<double> density1;
   clover::Buffer2D<double> energy0;
@@ -166,7 +187,7 @@ struct field_type {
   size_t vels_wk_stride;
   size_t flux_x_stride, flux_y_stride;
 
-  explicit field_type(size_t xrange, size_t yrange, clover::context &ctx);
+  explicit field_type(size_t xrange, size_t yrange, clover::context &ctx, arena_type arena = arena_type::off);
 };
 
 struct tile_info {
@@ -177,16 +198,28 @@ struct tile_info {
   int t_left, t_right, t_bottom, t_top;
 };
 
+// Versions of the fields ideal_gas and viscosity read and write, 0 until first written, see dirty.h
+struct field_stamps {
+  std::uint64_t primary{};        // density0, energy0, xvel0 and yvel0
+  std::uint64_t eos{};            // pressure and soundspeed
+  std::uint64_t eos_from{};       // primary the eos came from, 0 if from the predictor's level 1 fields
+  std::uint64_t viscosity{};      // viscosity
+  std::uint64_t viscosity_from{}; // eos the viscosity came from
+  std::array<std::uint64_t, NUM_FIELDS> halo{}; // Version of each field when its halo was last exchanged
+  std::array<int, NUM_FIELDS> halo_depth{};
+};
+
 struct tile_type {
 
   tile_info info;
   field_type field;
+  field_stamps stamps;
 
-  explicit tile_type(const tile_info &info, clover::context &ctx)
+  explicit tile_type(const tile_info &info, clover::context &ctx, arena_type arena = arena_type::off)
       : info(info),
         // (t_xmin-2:t_xmax+2, t_ymin-2:t_ymax+2)
         // XXX see build_field()
-        field((info.t_xmax + 2) - (info.t_xmin - 2) + 1, (info.t_ymax + 2) - (info.t_ymin - 2) + 1, ctx) {}
+        field((info.t_xmax + 2) - (info.t_xmin - 2) + 1, (info.t_ymax + 2) - (info.t_ymin - 2) + 1, ctx, arena) {}
 };
 
 struct chunk_type {
@@ -200,6 +233,7 @@ struct chunk_type {
   //	std::vector<double > hm_left_rcv_buffer, hm_right_rcv_buffer, hm_bottom_rcv_buffer, hm_top_rcv_buffer;
   //	std::vector<double > hm_left_snd_buffer, hm_right_snd_buffer, hm_bottom_snd_buffer, hm_top_snd_buffer;
   const std::array<int, 4> chunk_neighbours; // Chunks, not tasks, so we can overload in the future
+  const std::vector<int> chunk_tasks;        // Owning task of each chunk, indexed by chunk - 1
 
   const int task; // MPI task
   const int x_min;
@@ -214,22 +248,34 @@ struct chunk_type {
   //  clover::Buffer1D<double> left_snd_buffer, right_snd_buffer, bottom_snd_buffer, top_snd_buffer;
 
   std::vector<tile_type> tiles;
+  std::uint64_t stamp{}; // Last version handed out to the tiles' field_stamps
 
   chunk_type(const std::array<int, 4> &chunkNeighbours,                                //
+             const std::vector<int> &chunkTasks,                                       //
              int task,                                                                 //
              int xMin, int yMin, int xMax, int yMax,                                   //
              int left, int right, int bottom, int top,                                 //
              int leftBoundary, int rightBoundary, int bottomBoundary, int topBoundary, //
              int tiles_per_chunk);
+
+  // The task owning the chunk across the given face, only valid if that face is not external
+  [[nodiscard]] int neighbour_task(int face) const { return chunk_tasks[chunk_neighbours[face] - 1]; }
 };
 
 // Collection of globally defined variables
 struct global_config {
   std::string dumpDir;
   bool staging_buffer;
+  halo_exchange_type halo_exchange;
+  advection_kernel_type advection_kernel;
+  store_type stores;
+  bool reproducible; // Exact field summary totals, see reproducible.h
+  bool fused_summary; // Summary sums taken by reset_field, see reset_field.h
+  arena_type arena;   // Allocation of the tile fields, see arena.h
+  std::string autotune; // Cache file of --autotune while there are knobs left to try, empty otherwise, see autotune.h
   std::vector<state_type> states;
   int number_of_states;
-  int tiles_per_chunk;
+  int tiles_per_chunk; // 0 for tiles_per_chunk auto, until start picks the layout, see tiling.h
   int test_problem;
   bool profiler_on;
   double end_time;
@@ -250,11 +296,25 @@ struct global_config {
 
   int visit_frequency;
   int summary_frequency;
+  int warmup_steps; // Steps left out of the steady-state step times, see step_times.h
   int number_of_chunks;
 
   grid_type grid;
 };
 
+// Totals from the latest field summary, only the boss holds the reduced values
+struct summary_type {
+  double vol, mass, ie, ke, press;
+};
+
+// This rank's field summary sums, taken by reset_field on the steps a summary follows, see reset_field.h
+struct fused_summary_type {
+  bool due;           // Set by hydro_step for the next reset_field
+  bool taken;         // Set by reset_field once it has the sums and the ideal gas update
+  std::uint64_t from; // Version of the level 0 fields the sums are of, see dirty.h
+  double vol, mass, ie, ke, press;
+};
+
 struct global_variables {
   const global_config config;
   clover::context context;
@@ -273,8 +333,16 @@ struct global_variables {
   bool report_test_fail = false;
   int jdt{}, kdt{};
 
+  summary_type summary{};
+  fused_summary_type fused{};
+
   bool profiler_on = false; // Internal code profiler to make comparisons across systems easier
   profiler_type profiler{};
 
+  // Start as configured, --autotune may switch them between steps
+  halo_exchange_type halo_exchange;
+  advection_kernel_type advection_kernel;
+  store_type stores;
+
   global_variables(const global_config &config, clover::context queue, chunk_type chunk);
 };
@@ -0,0 +1,130 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "dirty.h"
+
+#include "ideal_gas.h"
+#include "update_halo.h"
+#include "viscosity.h"
+
+namespace clover::dirty {
+
+// Version of the field's data on a tile, 0 for the fields not tracked
+static std::uint64_t version(const field_stamps &s, int field) {
+  switch (field) {
+    case field_density0:
+    case field_energy0:
+    case field_xvel0:
+    case field_yvel0: return s.primary;
+    case field_pressure:
+    case field_soundspeed: return s.eos;
+    case field_viscosity: return s.viscosity;
+    default: return 0;
+  }
+}
+
+static bool eos_current(const field_stamps &s) { return s.eos != 0 && s.eos_from == s.primary && s.primary != 0; }
+
+void primary_written(global_variables &globals) {
+  const std::uint64_t v = ++globals.chunk.stamp;
+  for (tile_type &t : globals.chunk.tiles)
+    t.stamps.primary = v;
+}
+
+void predicted(global_variables &globals) {
+  const std::uint64_t v = ++globals.chunk.stamp;
+  for (tile_type &t : globals.chunk.tiles) {
+    t.stamps.eos = v;
+    t.stamps.eos_from = 0;
+  }
+}
+
+void scratch_written(global_variables &globals) {
+  const std::uint64_t v = ++globals.chunk.stamp;
+  for (tile_type &t : globals.chunk.tiles) {
+    t.stamps.primary = t.stamps.eos = t.stamps.viscosity = v;
+    t.stamps.eos_from = t.stamps.viscosity_from = 0;
+  }
+}
+
+void summary_taken(global_variables &globals) {
+  const std::uint64_t v = ++globals.chunk.stamp;
+  for (tile_type &t : globals.chunk.tiles) {
+    t.stamps.eos = v;
+    t.stamps.eos_from = t.stamps.primary;
+  }
+  globals.fused.taken = false;
+  globals.fused.from = globals.chunk.tiles.empty() ? 0 : globals.chunk.tiles.front().stamps.primary;
+}
+
+bool summary_current(const global_variables &globals) {
+  if (globals.fused.from == 0) return false;
+  for (const tile_type &t : globals.chunk.tiles)
+    if (t.stamps.primary != globals.fused.from) return false;
+  return true;
+}
+
+void ideal_gas(global_variables &globals) {
+  const std::uint64_t v = globals.chunk.stamp + 1;
+  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
+    field_stamps &s = globals.chunk.tiles[tile].stamps;
+    if (eos_current(s)) continue;
+    ::ideal_gas(globals, tile, false);
+    s.eos = globals.chunk.stamp = v;
+    s.eos_from = s.primary;
+  }
+}
+
+void viscosity(global_variables &globals) {
+  bool current = true;
+  for (const tile_type &t : globals.chunk.tiles)
+    current = current && eos_current(t.stamps) && t.stamps.viscosity != 0 && t.stamps.viscosity_from == t.stamps.eos;
+  if (current) return;
+  ::viscosity(globals);
+  const std::uint64_t v = ++globals.chunk.stamp;
+  for (tile_type &t : globals.chunk.tiles) {
+    t.stamps.viscosity = v;
+    t.stamps.viscosity_from = t.stamps.eos;
+  }
+}
+
+void update_halo(global_variables &globals, const int fields[NUM_FIELDS], int depth) {
+  int stale[NUM_FIELDS];
+  bool any = false;
+  for (int field = 0; field < NUM_FIELDS; ++field) {
+    stale[field] = 0;
+    if (fields[field] != 1) continue;
+    for (const tile_type &t : globals.chunk.tiles) {
+      std::uint64_t v = version(t.stamps, field);
+      if (v == 0 || t.stamps.halo[field] != v || t.stamps.halo_depth[field] < depth) stale[field] = 1;
+    }
+    any = any || stale[field] == 1;
+  }
+  if (!any) return;
+  ::update_halo(globals, stale, depth);
+  for (tile_type &t : globals.chunk.tiles) {
+    for (int field = 0; field < NUM_FIELDS; ++field) {
+      if (stale[field] != 1) continue;
+      t.stamps.halo[field] = version(t.stamps, field);
+      t.stamps.halo_depth[field] = depth;
+    }
+  }
+}
+
+} // namespace clover::dirty
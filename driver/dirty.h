@@ -0,0 +1,67 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "definitions.h"
+
+//  @brief Dirty tracking of the fields derived from the level 0 fields
+//  @details timestep(), field_summary() and visit() each start by bringing the
+//  pressure, soundspeed and viscosity up to date with density0, energy0 and the
+//  level 0 velocities, and by exchanging their halos. Between two steps nothing
+//  changes those inputs, so with summaries or visit dumps every step most of
+//  these passes repeat the previous one. Each pass stamps the tile fields it
+//  writes with a new version (field_stamps): the level 0 fields when
+//  generate_chunk or reset_field writes them, the pressure and soundspeed when
+//  ideal_gas writes them, the viscosity when viscosity writes it, and each
+//  field's halo when it is exchanged. The drivers below skip a pass whose
+//  outputs already carry the versions of its inputs. The stamps change only in
+//  the collective drivers, in the same order on every rank, so all ranks skip
+//  the same halo exchanges. Code writing the level 0 fields itself, through
+//  simulation::variables() for instance, has to call primary_written()
+//  afterwards.
+namespace clover::dirty {
+
+// Stamps density0, energy0, xvel0 and yvel0 of every tile as written
+void primary_written(global_variables &globals);
+
+// Stamps the pressure and soundspeed as written from the level 1 fields by the predictor of PdV
+void predicted(global_variables &globals);
+
+// Stamps the level 0 and derived fields as overwritten, after advection used their storage for its work arrays
+// (--arena aliased, see arena.h). Call before the primary_written() of reset_field.
+void scratch_written(global_variables &globals);
+
+// Stamps the pressure and soundspeed as written from the current level 0 fields, and the fused summary sums as taken
+// from them, after a reset_field that took them (globals.fused.taken). Call after primary_written().
+void summary_taken(global_variables &globals);
+
+// Whether globals.fused holds this rank's summary sums of the current level 0 fields
+bool summary_current(const global_variables &globals);
+
+// ideal_gas(globals, tile, false) on the tiles whose pressure and soundspeed are older than their level 0 fields
+void ideal_gas(global_variables &globals);
+
+// viscosity(globals) unless every tile's viscosity is as new as its pressure and level 0 fields
+void viscosity(global_variables &globals);
+
+// update_halo(globals, fields, depth) for the fields whose halos are not yet exchanged to depth for their current version
+void update_halo(global_variables &globals, const int fields[NUM_FIELDS], int depth);
+
+} // namespace clover::dirty
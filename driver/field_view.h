@@ -0,0 +1,68 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "definitions.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace clover {
+
+// Read-only view of one field of a tile straight into the model's storage, the two halo cells on each side included.
+// Element (x, y), counted from the bottom left halo cell, is data[x * x_stride + y * y_stride].
+struct field_view {
+  enum class memory { host, device, none };
+  const double *data;
+  size_t nx, ny;
+  std::ptrdiff_t x_stride, y_stride;
+  memory location; // data is nullptr for none (the layout may still be set), and device memory cannot be read from the host
+};
+
+// The storage behind a field_parameter, nullptr for anything else
+inline Buffer2D<double> *field_buffer(field_type &field, int f) {
+  switch (f) {
+    case field_density0: return &field.density0;
+    case field_density1: return &field.density1;
+    case field_energy0: return &field.energy0;
+    case field_energy1: return &field.energy1;
+    case field_pressure: return &field.pressure;
+    case field_viscosity: return &field.viscosity;
+    case field_soundspeed: return &field.soundspeed;
+    case field_xvel0: return &field.xvel0;
+    case field_xvel1: return &field.xvel1;
+    case field_yvel0: return &field.yvel0;
+    case field_yvel1: return &field.yvel1;
+    case field_vol_flux_x: return &field.vol_flux_x;
+    case field_vol_flux_y: return &field.vol_flux_y;
+    case field_mass_flux_x: return &field.mass_flux_x;
+    case field_mass_flux_y: return &field.mass_flux_y;
+    default: return nullptr;
+  }
+}
+
+} // namespace clover
+
+// Implemented by each model, as only the model knows where and in which order its fields are stored
+clover::field_view clover_field_view(global_variables &globals, int tile, int field);
+
+// A host copy of the buffer's current contents, in the order field_view strides over, brought back from the device
+// first where the model keeps the current copy there. Also implemented by each model.
+std::vector<double> clover_field_host(global_variables &globals, clover::Buffer2D<double> &buffer);
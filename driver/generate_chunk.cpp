@@ -0,0 +1,76 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Mesh chunk generation support
+//  @details Computes the cell bounding box of each state so that the generator
+//  only has to visit the cells a state can cover. The geometry test itself is
+//  still done per cell by the kernels, the box here is padded by one cell on each
+//  side so round-off in the vertex and cell coordinates can never exclude a cell
+//  that the per-cell test would have accepted.
+
+#include "generate_chunk.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Index range [from, to) of cells whose vertices may touch [lo, hi], where vertex i sits at origin + delta * (i - offset)
+static void state_extent_1d(double lo, double hi, double origin, double delta, int offset, int range, int &from, int &to) {
+  const double first = std::floor((lo - origin) / delta) + offset - 2;
+  const double last = std::floor((hi - origin) / delta) + offset + 2;
+  from = static_cast<int>(std::clamp(first, 0.0, static_cast<double>(range)));
+  to = static_cast<int>(std::clamp(last, 0.0, static_cast<double>(range)));
+}
+
+state_extent generate_state_extent(const global_variables &globals, int tile, const state_type &state) {
+
+  const tile_info &info = globals.chunk.tiles[tile].info;
+  const grid_type &grid = globals.config.grid;
+
+  // Same geometry as initialise_chunk
+  double dx = (grid.xmax - grid.xmin) / (double)(grid.x_cells);
+  double dy = (grid.ymax - grid.ymin) / (double)(grid.y_cells);
+  double xmin = grid.xmin + dx * (double)(info.t_left - 1);
+  double ymin = grid.ymin + dy * (double)(info.t_bottom - 1);
+
+  int xrange = (info.t_xmax + 2) - (info.t_xmin - 2) + 1;
+  int yrange = (info.t_ymax + 2) - (info.t_ymin - 2) + 1;
+
+  double x_lo, x_hi, y_lo, y_hi;
+  switch (state.geometry) {
+    case g_rect:
+      x_lo = state.xmin, x_hi = state.xmax;
+      y_lo = state.ymin, y_hi = state.ymax;
+      break;
+    case g_circ:
+      x_lo = state.xmin - state.radius, x_hi = state.xmin + state.radius;
+      y_lo = state.ymin - state.radius, y_hi = state.ymin + state.radius;
+      break;
+    case g_point:
+      x_lo = x_hi = state.xmin;
+      y_lo = y_hi = state.ymin;
+      break;
+    default: return {true, 0, 0, 0, 0};
+  }
+
+  state_extent extent{};
+  state_extent_1d(x_lo, x_hi, xmin, dx, 1 + info.t_xmin, xrange, extent.fromX, extent.toX);
+  state_extent_1d(y_lo, y_hi, ymin, dy, 1 + info.t_ymin, yrange, extent.fromY, extent.toY);
+  extent.empty = extent.fromX >= extent.toX || extent.fromY >= extent.toY;
+  return extent;
+}
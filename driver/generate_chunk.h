@@ -21,4 +21,14 @@
 
 #include "definitions.h"
 
+// Tile-local (0-based, including the two ghost cells on each side) cell range [from, to) that a state can possibly
+// cover, used to restrict the per-state sweep in generate_chunk to a bounding box instead of the whole tile.
+struct state_extent {
+  bool empty;
+  int fromX, fromY;
+  int toX, toY;
+};
+
+state_extent generate_state_extent(const global_variables &globals, int tile, const state_type &state);
+
 void generate_chunk(const int tile, global_variables &globals);
@@ -0,0 +1,192 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Huge page backing for the host field storage
+//  @details Blocks on the huge page path are recorded with their size and how
+//  they were mapped, which release() needs for munmap and report() for telling
+//  the huge pages apart from the rest. With advise the kernel decides per 2 MiB
+//  extent on first touch, so report() reads the AnonHugePages of the mappings
+//  holding the blocks from /proc/self/smaps instead of trusting the madvise.
+
+#include "huge_pages.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+#include "comms.h"
+
+namespace clover::pages {
+
+namespace {
+
+struct block {
+  std::size_t bytes;
+  bool hugetlb;
+};
+
+// Fields of the same shape then start their rows at the same offset in a vector, see simd::aligned_row
+constexpr std::size_t line = 64;
+
+std::atomic<policy> selected{policy::off};
+std::mutex lock;
+std::map<void *, block> blocks;
+
+std::size_t huge_page_size() {
+  static const std::size_t size = []() -> std::size_t {
+    std::ifstream meminfo("/proc/meminfo");
+    for (std::string line; std::getline(meminfo, line);) {
+      if (line.rfind("Hugepagesize:", 0) == 0) {
+        std::size_t kib = std::strtoull(line.c_str() + 13, nullptr, 10);
+        if (kib > 0) return kib << 10;
+      }
+    }
+    return std::size_t(2) << 20;
+  }();
+  return size;
+}
+
+std::string thp_mode() {
+  std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string modes;
+  std::getline(enabled, modes);
+  auto open = modes.find('['), close = modes.find(']');
+  if (open == std::string::npos || close == std::string::npos) return "unavailable";
+  return modes.substr(open + 1, close - open - 1);
+}
+
+// AnonHugePages, in bytes, of the mappings that hold a recorded block
+std::size_t anon_huge_bytes(std::vector<std::pair<std::uintptr_t, std::uintptr_t>> ranges) {
+  std::sort(ranges.begin(), ranges.end());
+  std::ifstream smaps("/proc/self/smaps");
+  std::size_t total = 0;
+  bool counted = false;
+  for (std::string line; std::getline(smaps, line);) {
+    if (auto dash = line.find('-'); dash != std::string::npos && line.find(':') > line.find(' ')) {
+      // a mapping header: start-end perms offset dev inode path
+      std::uintptr_t start = std::strtoull(line.c_str(), nullptr, 16), end = std::strtoull(line.c_str() + dash + 1, nullptr, 16);
+      auto it = std::lower_bound(ranges.begin(), ranges.end(), std::make_pair(start, std::uintptr_t(0)));
+      counted = it != ranges.end() && it->first < end;
+    } else if (counted && line.rfind("AnonHugePages:", 0) == 0) {
+      total += std::strtoull(line.c_str() + 14, nullptr, 10) << 10;
+    }
+  }
+  return total;
+}
+
+} // namespace
+
+void set_policy(policy p) { selected = p; }
+policy current_policy() { return selected; }
+
+std::string policy_name(policy p) {
+  switch (p) {
+    case policy::off: return "off";
+    case policy::advise: return "advise";
+    case policy::hugetlb: return "hugetlb";
+  }
+  return "unknown";
+}
+
+void *allocate(std::size_t bytes) {
+  policy p = selected;
+  std::size_t page = huge_page_size();
+  if (p == policy::off || bytes < page) return std::aligned_alloc(line, (bytes + line - 1) / line * line);
+  std::size_t rounded = (bytes + page - 1) / page * page;
+  void *ptr = nullptr;
+  bool hugetlb = false;
+  if (p == policy::hugetlb) {
+    ptr = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    hugetlb = ptr != MAP_FAILED;
+    if (!hugetlb) ptr = nullptr;
+  }
+  if (!ptr) {
+    ptr = std::aligned_alloc(page, rounded);
+    if (!ptr) return nullptr;
+    madvise(ptr, rounded, MADV_HUGEPAGE);
+  }
+  std::lock_guard<std::mutex> guard(lock);
+  blocks[ptr] = {rounded, hugetlb};
+  return ptr;
+}
+
+void release(void *ptr) {
+  if (!ptr) return;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (auto it = blocks.find(ptr); it != blocks.end()) {
+      block b = it->second;
+      blocks.erase(it);
+      if (b.hugetlb) {
+        munmap(ptr, b.bytes);
+        return;
+      }
+    }
+  }
+  std::free(ptr);
+}
+
+void report(parallel_ &parallel, std::ostream &out) {
+  policy p = selected;
+  if (p == policy::off) return;
+  // {recorded bytes, bytes on huge pages, blocks, hugetlb blocks}
+  std::vector<double> usage(4, 0.0);
+  // Without MPI every rank is a thread of this process and sees all of its blocks, so only the boss counts them
+#ifdef NO_MPI
+  bool counts = parallel.boss;
+#else
+  bool counts = true;
+#endif
+  if (counts) {
+    std::vector<std::pair<std::uintptr_t, std::uintptr_t>> advised;
+    std::lock_guard<std::mutex> guard(lock);
+    for (auto &[ptr, b] : blocks) {
+      usage[0] += double(b.bytes);
+      usage[2] += 1;
+      if (b.hugetlb) {
+        usage[1] += double(b.bytes);
+        usage[3] += 1;
+      } else {
+        auto start = reinterpret_cast<std::uintptr_t>(ptr);
+        advised.emplace_back(start, start + b.bytes);
+      }
+    }
+    if (!advised.empty()) usage[1] += double(anon_huge_bytes(advised));
+  }
+  clover_sum(usage);
+  if (!parallel.boss) return;
+  double page = double(huge_page_size());
+  std::ostringstream line;
+  line << "Huge pages (" << policy_name(p) << ", transparent huge pages " << thp_mode() << "): " << std::fixed << std::setprecision(0)
+       << usage[1] / page << " of " << usage[0] / page << " " << (huge_page_size() >> 10) << " KiB pages backing " << usage[2] << " arrays";
+  if (p == policy::hugetlb) line << ", " << usage[3] << " of them from the hugetlbfs pool";
+  out << line.str() << std::endl << std::endl;
+}
+
+} // namespace clover::pages
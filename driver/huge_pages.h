@@ -0,0 +1,56 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+// The host models' context.h includes this, ahead of comms.h
+struct parallel_;
+
+//  @brief Huge page backing for the host field storage
+//  @details With 4 KiB pages every stencil row of a large tile lands on its own
+//  page, and the fields of one kernel cover far more pages than the TLB holds.
+//  The host models allocate their buffers through allocate() and release(),
+//  which, for anything of at least one huge page, either align the block to
+//  the huge page size and madvise(MADV_HUGEPAGE) it (advise), or map it from the
+//  hugetlbfs pool with MAP_HUGETLB (hugetlb), falling back to advise when the
+//  pool is empty. Smaller blocks and the off policy are only aligned to a cache
+//  line. The policy is per process, so ranks running as threads of one (see
+//  mpi_shim.h) share it.
+namespace clover::pages {
+
+enum class policy { off, advise, hugetlb };
+
+// Applies to the blocks allocated afterwards
+void set_policy(policy p);
+policy current_policy();
+std::string policy_name(policy p);
+
+void *allocate(std::size_t bytes);
+// Releases a block of allocate(), or of std::malloc
+void release(void *ptr);
+
+// Prints, on the boss, how much of the live blocks the kernel has backed with huge pages so far, must be called on
+// every rank. With advise that counts only what has been touched, which the start-up initialisation mostly has
+void report(parallel_ &parallel, std::ostream &out);
+
+} // namespace clover::pages
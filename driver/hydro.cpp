@@ -21,15 +21,21 @@
 #include "PdV.h"
 #include "accelerate.h"
 #include "advection.h"
+#include "autotune.h"
+#include "dirty.h"
 #include "field_summary.h"
 #include "flux_calc.h"
+#include "logging.h"
+#include "perf_counters.h"
 #include "reset_field.h"
 #include "shared.h"
+#include "step_times.h"
 #include "timer.h"
 #include "timestep.h"
+#include "trace.h"
 #include "visit.h"
 
-extern std::ostream g_out;
+extern thread_local std::ostream g_out;
 
 int maxloc(const std::vector<double> &totals, const int len) {
   int loc = -1;
@@ -43,73 +49,126 @@ int maxloc(const std::vector<double> &totals, const int len) {
   return loc;
 }
 
-void hydro(global_variables &globals, parallel_ &parallel) {
+// Whether a field summary ends the current step, from hydro_step or, on the last step, from hydro_complete
+static bool summary_follows(const global_variables &globals) {
+  if (globals.config.summary_frequency != 0 && globals.step % globals.config.summary_frequency == 0) return true;
+  return globals.time + globals.dt + g_small > globals.config.end_time || globals.step >= globals.config.end_step;
+}
 
-  double timerstart = timer();
+void hydro_step(global_variables &globals, parallel_ &parallel) {
 
+  globals.step += 1;
+  clover::trace::begin("step");
+
+  clover::trace::begin("timestep");
+  timestep(globals, parallel);
+  clover::trace::end();
   if (!globals.config.dumpDir.empty())
-    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_05_hydro.txt");
+    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_1_timestep.txt");
 
-  while (true) {
+  clover::trace::begin("PdV");
+  PdV(globals, true);
+  clover::dirty::predicted(globals);
+  clover::trace::end();
+  if (!globals.config.dumpDir.empty())
+    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_2_PdV.txt");
 
-    double step_time = timer();
+  clover::trace::begin("accelerate");
+  accelerate(globals);
+  clover::trace::end();
+  if (!globals.config.dumpDir.empty())
+    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_3_accelerate.txt");
 
-    globals.step += 1;
+  clover::trace::begin("PdV");
+  PdV(globals, false);
+  clover::trace::end();
+  if (!globals.config.dumpDir.empty())
+    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_4_PdV.txt");
 
-    timestep(globals, parallel);
-    if (!globals.config.dumpDir.empty())
-      clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_1_timestep.txt");
+  clover::trace::begin("flux_calc");
+  flux_calc(globals);
+  clover::trace::end();
+  if (!globals.config.dumpDir.empty())
+    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_5_flux_calc.txt");
+
+  clover::trace::begin("advection");
+  advection(globals);
+  // The work arrays of advection may share the storage of the level 0 and derived fields, see arena.h
+  if (globals.config.arena == arena_type::aliased) clover::dirty::scratch_written(globals);
+  clover::trace::end();
+  if (!globals.config.dumpDir.empty())
+    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_6_advection.txt");
+
+  clover::trace::begin("reset_field");
+  globals.fused.due = globals.config.fused_summary && summary_follows(globals);
+  reset_field(globals);
+  clover::dirty::primary_written(globals);
+  if (globals.fused.taken) clover::dirty::summary_taken(globals);
+  clover::trace::end();
+  if (!globals.config.dumpDir.empty())
+    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_7_reset_field.txt");
+
+  globals.advect_x = !globals.advect_x;
+
+  globals.time += globals.dt;
+  //		globals.queue.wait_and_throw();
+
+  if (globals.config.summary_frequency != 0) {
+    if (globals.step % globals.config.summary_frequency == 0) {
+      clover::trace::begin("field_summary");
+      field_summary(globals, parallel);
+      clover::trace::end();
+    }
+  }
+  if (globals.config.visit_frequency != 0) {
+    if (globals.step % globals.config.visit_frequency == 0) {
+      clover::trace::begin("visit");
+      visit(globals, parallel);
+      clover::trace::end();
+    }
+  }
+  clover::trace::end(); // step
+}
 
-    PdV(globals, true);
-    if (!globals.config.dumpDir.empty())
-      clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_2_PdV.txt");
+bool hydro_done(const global_variables &globals) {
+  return globals.time + g_small > globals.config.end_time || globals.step >= globals.config.end_step;
+}
 
-    accelerate(globals);
-    if (!globals.config.dumpDir.empty())
-      clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_3_accelerate.txt");
+void hydro_complete(global_variables &globals, parallel_ &parallel) {
+  globals.complete = true;
+  field_summary(globals, parallel);
+  if (globals.config.visit_frequency != 0) visit(globals, parallel);
+}
 
-    PdV(globals, false);
-    if (!globals.config.dumpDir.empty())
-      clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_4_PdV.txt");
+void hydro(global_variables &globals, parallel_ &parallel) {
 
-    flux_calc(globals);
-    if (!globals.config.dumpDir.empty())
-      clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_5_flux_calc.txt");
+  double timerstart = timer();
 
-    advection(globals);
-    if (!globals.config.dumpDir.empty())
-      clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_6_advection.txt");
+  if (!globals.config.dumpDir.empty())
+    clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_05_hydro.txt");
 
-    reset_field(globals);
-    if (!globals.config.dumpDir.empty())
-      clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_7_reset_field.txt");
+  // Sometimes there can be a significant start up cost that appears in the first step.
+  // Sometimes it is due to the number of MPI tasks, or OpenCL kernel compilation.
+  // On the short test runs, this can skew the results, so should be taken into account
+  //  in recorded run times. The steady-state statistics leave out the first warmup_steps.
+  double first_step = 0, second_step = 0;
+  std::vector<double> step_times;
 
-    globals.advect_x = !globals.advect_x;
+  while (true) {
 
-    globals.time += globals.dt;
-    //		globals.queue.wait_and_throw();
+    double step_time = timer();
 
-    if (globals.config.summary_frequency != 0) {
-      if (globals.step % globals.config.summary_frequency == 0) field_summary(globals, parallel);
-    }
-    if (globals.config.visit_frequency != 0) {
-      if (globals.step % globals.config.visit_frequency == 0) visit(globals, parallel);
-    }
+    hydro_step(globals, parallel);
 
-    // Sometimes there can be a significant start up cost that appears in the first step.
-    // Sometimes it is due to the number of MPI tasks, or OpenCL kernel compilation.
-    // On the short test runs, this can skew the results, so should be taken into account
-    //  in recorded run times.
     double wall_clock{};
-    double first_step = 0, second_step = 0;
-    if (globals.step == 1) first_step = timer() - step_time;
-    if (globals.step == 2) second_step = timer() - step_time;
+    step_times.push_back(timer() - step_time);
+    if (!globals.config.autotune.empty()) clover::tune::step(globals, parallel, step_times.back());
+    if (globals.step == 1) first_step = step_times.back();
+    if (globals.step == 2) second_step = step_times.back();
 
-    if (globals.time + g_small > globals.config.end_time || globals.step >= globals.config.end_step) {
+    if (hydro_done(globals)) {
 
-      globals.complete = true;
-      field_summary(globals, parallel);
-      if (globals.config.visit_frequency != 0) visit(globals, parallel);
+      hydro_complete(globals, parallel);
 
       wall_clock = timer() - timerstart;
       if (parallel.boss) {
@@ -118,10 +177,13 @@ void hydro(global_variables &globals, parallel_ &parallel) {
               << "Clover is finishing" << std::endl
               << "Wall clock " << wall_clock << std::endl
               << "First step overhead " << first_step - second_step << std::endl;
-        std::cout << " Wall clock " << wall_clock << std::endl //
-                  << " First step overhead " << first_step - second_step << std::endl;
+        if (clover::logging::to_console(clover::logging::level::summary))
+          std::cout << " Wall clock " << wall_clock << std::endl //
+                    << " First step overhead " << first_step - second_step << std::endl;
       }
 
+      clover::steps::report(globals, parallel, step_times);
+
       std::vector<double> totals(parallel.max_task);
       if (globals.profiler_on) {
         // First we need to find the maximum kernel time for each task. This
@@ -196,8 +258,9 @@ void hydro(global_variables &globals, parallel_ &parallel) {
                    << std::endl;
           };
           writeProfile(g_out);
-          writeProfile(std::cout);
+          if (clover::logging::to_console(clover::logging::level::summary)) writeProfile(std::cout);
         }
+        clover::counters::report(globals, parallel);
       }
 
       // clover_finalize(); Skipped as just closes the file and calls MPI_Finalize (which is done back in main).
@@ -205,19 +268,21 @@ void hydro(global_variables &globals, parallel_ &parallel) {
       break;
     }
 
-    if (parallel.boss) {
+    if (parallel.boss && clover::logging::step_line(globals.step)) {
       wall_clock = timer() - timerstart;
       double step_clock = timer() - step_time;
-      g_out << "Wall clock " << wall_clock << std::endl;
-      std::cout << " Wall clock " << wall_clock << std::endl;
       double cells = globals.config.grid.x_cells * globals.config.grid.y_cells;
       double rstep = globals.step;
       double grind_time = wall_clock / (rstep * cells);
       double step_grind = step_clock / cells;
-      std::cout << " Average time per cell " << grind_time << std::endl;
+      g_out << "Wall clock " << wall_clock << std::endl;
       g_out << "Average time per cell " << grind_time << std::endl;
-      std::cout << "  Step time per cell    " << step_grind << std::endl;
       g_out << "Step time per cell    " << step_grind << std::endl;
+      if (clover::logging::to_console(clover::logging::level::step)) {
+        std::cout << " Wall clock " << wall_clock << std::endl;
+        std::cout << " Average time per cell " << grind_time << std::endl;
+        std::cout << "  Step time per cell    " << step_grind << std::endl;
+      }
     }
   }
 }
@@ -21,4 +21,14 @@
 #include "comms.h"
 #include "definitions.h"
 
+// Runs to end_time or end_step, reporting the wall clock and profile as it goes
 void hydro(global_variables &globals, parallel_ &parallel);
+
+// One timestep, including the summary and visit output due on it
+void hydro_step(global_variables &globals, parallel_ &parallel);
+
+// Whether the run has reached end_time or end_step
+bool hydro_done(const global_variables &globals);
+
+// The final summary, which checks the test problem, and visit output
+void hydro_complete(global_variables &globals, parallel_ &parallel);
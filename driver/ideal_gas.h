@@ -22,3 +22,6 @@
 #include "definitions.h"
 
 void ideal_gas(global_variables &globals, const int tile, bool predict);
+
+// Whether this model has the streaming store variants of the ideal gas, reset field and advection volume loops
+bool streaming_stores_supported();
@@ -21,6 +21,8 @@
 
 #include "comms.h"
 #include "definitions.h"
+#include "huge_pages.h"
+#include "logging.h"
 #include <functional>
 #include <iomanip>
 #include <memory>
@@ -34,7 +36,22 @@ struct run_args {
   std::string inFile;
   std::string outFile;
   staging_buffer staging_buffer;
+  halo_exchange_type halo_exchange;
+  advection_kernel_type advection_kernel;
+  store_type stores;
+  bool reproducible;
+  bool fusedSummary;
   std::optional<bool> profile;
+  std::string tracePrefix;
+  bool perfCounters;
+  int ranks;
+  std::string ensembleFile;
+  clover::logging::level logLevel;
+  int logEvery;
+  size_t logBuffer;
+  std::string tuneCache;
+  clover::pages::policy hugePages;
+  std::optional<arena_type> arena;
 };
 
 struct model {
@@ -63,6 +80,55 @@ std::pair<T, run_args> list_and_parse(bool silent, const std::vector<T> &devices
         << "      --out                    <FILE>    Custom clover.out file FILE (defaults to clover.out if unspecified)\n"
         << "      --dump                    <DIR>    Dumps all field data in ASCII to ./DIR for debugging, DIR is created if missing\n"
         << "      --profile                          Enables kernel profiling, this takes precedence over the profiler_on in clover.in\n"
+        << "      --perf-counters                    Implies --profile, also collects hardware counters (IPC, cache misses) per kernel\n"
+        << "                                         through perf_event_open, requires kernel.perf_event_paranoid <= 2\n"
+        << "      --trace                <PREFIX>    Records a timeline of kernels, halo phases and MPI calls, each rank writes\n"
+        << "                                         PREFIX_<rank>.json in Chrome trace format (chrome://tracing or ui.perfetto.dev)\n"
+        << "      --ranks                     <N>    Builds without MPI only: run N ranks as threads of this process, the halo exchange\n"
+        << "                                         and reductions go through shared memory. Each rank starts its own OpenMP team,\n"
+        << "                                         so lower OMP_NUM_THREADS accordingly\n"
+        << "      --ensemble               <FILE>    Runs every deck listed in FILE in this one process, one line per member in the form\n"
+        << "                                         `DECK[; KEY=VALUE; ...]` where the deck lines after DECK override its keys,\n"
+        << "                                         states cannot be redefined.\n"
+        << "                                         Members are shared round-robin between the ranks, each runs on a single rank\n"
+        << "                                         and writes OUT with _<member> before its extension, OUT gets a table of all members\n"
+        << "      --halo-exchange <pack|datatype|shared|neighbour>\n"
+        << "                                         How MPI halo messages are built, defaults to pack which copies the halo into\n"
+        << "                                         buffers. datatype sends the halo in place through MPI derived datatypes.\n"
+        << "                                         shared lets neighbours on the same node unpack straight from each other's\n"
+        << "                                         buffers in an MPI-3 shared memory window. neighbour moves the whole halo,\n"
+        << "                                         corners included, with one neighbourhood collective per update. These are\n"
+        << "                                         only available for host models built with MPI\n"
+        << "      --advection       <scalar|simd>    Flux loops of the cell and momentum advection, defaults to scalar. simd is a\n"
+        << "                                         branch free variant that blends the van Leer stencil in vector registers\n"
+        << "                                         instead of branching per cell, only available for the omp model\n"
+        << "      --stores      <normal|streaming>   How the outputs that a loop only writes are stored, defaults to normal. streaming\n"
+        << "                                         uses non-temporal stores for ideal gas, reset field and the advection volumes,\n"
+        << "                                         which skip reading the line first and leave it out of cache. Pays off when the\n"
+        << "                                         tiles are far larger than the LLC, only available for the omp model\n"
+        << "      --reproducible                     Sum the field summaries exactly, so they are bitwise identical for any thread,\n"
+        << "                                         tile or rank count. Reads the fields back through host copies, which costs\n"
+        << "                                         a device to host transfer per summary on offload models\n"
+        << "      --fused-summary                    Take the field summary sums, and the ideal gas update they need, in the reset\n"
+        << "                                         field pass of the steps that end with a summary, instead of reading the fields\n"
+        << "                                         again afterwards. Only available for the serial and omp models\n"
+        << "      --autotune             <FILE>    Try the variants of --halo-exchange, --advection and --stores this build has over\n"
+        << "                                         the steps after the warmup, keep the fastest and cache the choices in FILE, keyed\n"
+        << "                                         by model, CPU, deck size and rank count. A run found in FILE starts with its choices\n"
+        << "      --huge-pages <off|advise|hugetlb>  Back the field arrays of host models with huge pages to cut TLB misses, defaults\n"
+        << "                                         to off. advise aligns them to the huge page size and asks for transparent huge\n"
+        << "                                         pages with madvise, hugetlb maps them from the reserved hugetlbfs pool\n"
+        << "                                         (vm.nr_hugepages) and falls back to advise once it runs out\n"
+        << "      --arena     <off|packed|aliased>   How a tile's field arrays are allocated, defaults to packed where available.\n"
+        << "                                         off allocates each array on its own, packed carves them all out of one block\n"
+        << "                                         per tile, aliased also lets the advection work arrays share the storage of\n"
+        << "                                         fields that are dead while they are live. Only available for the serial and\n"
+        << "                                         omp models, aliased falls back to packed with --dump or visit_frequency\n"
+        << "      --log-level <quiet|summary|step>   What the boss prints to stdout besides the banner and result, defaults to step.\n"
+        << "                                         summary adds the end of run reports, step adds the per-step lines\n"
+        << "      --log-every                 <N>    Write the per-step lines to stdout and OUT every Nth step only, defaults to 1\n"
+        << "      --log-buffer            <BYTES>    Size of the in-memory ring stdout and OUT are written through by a background\n"
+        << "                                         thread, defaults to 1048576. 0 writes (and flushes) directly\n"
         << "      --staging-buffer <true|false|auto> If true, use a host staging buffer for device-host MPI halo exchange.\n"
            "                                         If false, use device pointers directly for MPI halo exchange.\n"
         << "                                         Defaults to auto which elides the buffer if a device-aware (i.e CUDA-aware) is used.\n"
@@ -90,7 +156,9 @@ std::pair<T, run_args> list_and_parse(bool silent, const std::vector<T> &devices
   };
 
   T device = std::move(devices[0]);
-  auto config = run_args{"", "clover.in", "clover.out", run_args::staging_buffer::automatic, {}};
+  auto config = run_args{"", "clover.in", "clover.out", run_args::staging_buffer::automatic, halo_exchange_type::pack, advection_kernel_type::scalar,
+                         store_type::normal, false, false, {}, "", false, 1, "", clover::logging::level::step, 1, clover::logging::default_capacity, "",
+                         clover::pages::policy::off, {}};
   for (size_t i = 0; i < args.size(); ++i) {
     const auto &arg = args[i];
     if (arg == "--help" || arg == "-h") {
@@ -103,6 +171,11 @@ std::pair<T, run_args> list_and_parse(bool silent, const std::vector<T> &devices
       std::exit(EXIT_SUCCESS);
     } else if (arg == "--profile") {
       config.profile = true;
+    } else if (arg == "--perf-counters") {
+      config.profile = true;
+      config.perfCounters = true;
+    } else if (arg == "--trace") {
+      readParam(i, "--trace specified but no prefix was given", [&config](const auto &param) { config.tracePrefix = param; });
     } else if (arg == "--device") {
       readParam(i, "--device specified but no size was given", [&](const auto &param) {
         try {
@@ -133,6 +206,113 @@ std::pair<T, run_args> list_and_parse(bool silent, const std::vector<T> &devices
       readParam(i, "--in,--file specified but no path was given", [&config](const auto &param) { config.inFile = param; });
     } else if (arg == "--out") {
       readParam(i, "--out specified but no path was given", [&config](const auto &param) { config.outFile = param; });
+    } else if (arg == "--ranks") {
+      readParam(i, "--ranks specified but no count was given", [&](const auto &param) {
+        config.ranks = std::atoi(param.c_str());
+        if (config.ranks < 1) {
+          std::cerr << "Illegal --ranks option:" << param << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+#ifndef NO_MPI
+        if (!silent) std::cout << "# WARNING: --ranks is ignored when built with MPI, use the MPI launcher instead" << std::endl;
+#endif
+      });
+    } else if (arg == "--ensemble") {
+      readParam(i, "--ensemble specified but no file was given", [&config](const auto &param) { config.ensembleFile = param; });
+    } else if (arg == "--halo-exchange") {
+      readParam(i, "--halo-exchange specified but no option given, expecting <pack|datatype|shared|neighbour>", [&config](const auto &param) {
+        if (param == "pack") {
+          config.halo_exchange = halo_exchange_type::pack;
+        } else if (param == "datatype") {
+          config.halo_exchange = halo_exchange_type::datatype;
+        } else if (param == "shared") {
+          config.halo_exchange = halo_exchange_type::shared;
+        } else if (param == "neighbour") {
+          config.halo_exchange = halo_exchange_type::neighbour;
+        } else {
+          std::cerr << "Illegal --halo-exchange option:" << param << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+      });
+    } else if (arg == "--advection") {
+      readParam(i, "--advection specified but no option given, expecting <scalar|simd>", [&config](const auto &param) {
+        if (param == "scalar") {
+          config.advection_kernel = advection_kernel_type::scalar;
+        } else if (param == "simd") {
+          config.advection_kernel = advection_kernel_type::simd;
+        } else {
+          std::cerr << "Illegal --advection option:" << param << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+      });
+    } else if (arg == "--stores") {
+      readParam(i, "--stores specified but no option given, expecting <normal|streaming>", [&config](const auto &param) {
+        if (param == "normal") {
+          config.stores = store_type::normal;
+        } else if (param == "streaming") {
+          config.stores = store_type::streaming;
+        } else {
+          std::cerr << "Illegal --stores option:" << param << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+      });
+    } else if (arg == "--reproducible") {
+      config.reproducible = true;
+    } else if (arg == "--fused-summary") {
+      config.fusedSummary = true;
+    } else if (arg == "--autotune") {
+      readParam(i, "--autotune specified but no cache file was given", [&config](const auto &param) { config.tuneCache = param; });
+    } else if (arg == "--huge-pages") {
+      readParam(i, "--huge-pages specified but no option given, expecting <off|advise|hugetlb>", [&config](const auto &param) {
+        if (param == "off") {
+          config.hugePages = clover::pages::policy::off;
+        } else if (param == "advise") {
+          config.hugePages = clover::pages::policy::advise;
+        } else if (param == "hugetlb") {
+          config.hugePages = clover::pages::policy::hugetlb;
+        } else {
+          std::cerr << "Illegal --huge-pages option:" << param << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+      });
+    } else if (arg == "--arena") {
+      readParam(i, "--arena specified but no option given, expecting <off|packed|aliased>", [&config](const auto &param) {
+        if (param == "off") {
+          config.arena = arena_type::off;
+        } else if (param == "packed") {
+          config.arena = arena_type::packed;
+        } else if (param == "aliased") {
+          config.arena = arena_type::aliased;
+        } else {
+          std::cerr << "Illegal --arena option:" << param << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+      });
+    } else if (arg == "--log-level") {
+      readParam(i, "--log-level specified but no option given, expecting <quiet|summary|step>", [&config](const auto &param) {
+        if (param == "quiet") {
+          config.logLevel = clover::logging::level::quiet;
+        } else if (param == "summary") {
+          config.logLevel = clover::logging::level::summary;
+        } else if (param == "step") {
+          config.logLevel = clover::logging::level::step;
+        } else {
+          std::cerr << "Illegal --log-level option:" << param << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+      });
+    } else if (arg == "--log-every") {
+      readParam(i, "--log-every specified but no interval was given", [&config](const auto &param) {
+        config.logEvery = std::atoi(param.c_str());
+        if (config.logEvery < 1) {
+          std::cerr << "Illegal --log-every option:" << param << std::endl;
+          std::exit(EXIT_FAILURE);
+        }
+      });
+    } else if (arg == "--log-buffer") {
+      readParam(i, "--log-buffer specified but no size was given", [&config](const auto &param) {
+        config.logBuffer = std::strtoull(param.c_str(), nullptr, 10);
+      });
     } else if (arg == "--staging-buffer") {
       readParam(i, "--staging-buffer specified but no option given, expecting <true|false|auto>", [&config](const auto &param) {
         if (param == "true") {
@@ -0,0 +1,162 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Console verbosity and buffered output
+//  @details The ring never copies on the writer side: the bytes between done and
+//  written belong to the writer until done moves past them, and producers only
+//  ever fill the free part, so the writer can hand spans of the ring straight to
+//  the sink with the lock released. The writer wakes on the first byte after an
+//  idle period and then lets a batch build up for a short interval (or until the
+//  ring is half full), so a run of step lines costs one write to the sink.
+
+#include "logging.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace clover::logging {
+
+thread_local level console = level::step;
+thread_local int every = 1;
+
+void configure(level console_level, int step_interval) {
+  console = console_level;
+  every = std::max(step_interval, 1);
+}
+
+namespace {
+
+constexpr auto batch_interval = std::chrono::milliseconds(100);
+
+std::mutex registry_lock;
+std::vector<ring_buffer *> registry;
+
+} // namespace
+
+ring_buffer::ring_buffer(std::streambuf *sink, size_t capacity) : sink(sink), ring(std::max<size_t>(capacity, 1)) {
+  writer = std::thread([this]() { write_loop(); });
+  // std::exit (--help, argument errors) skips the destructors, so whatever is still queued is written out at exit
+  static std::once_flag at_exit;
+  std::call_once(at_exit, []() { std::atexit(drain_all); });
+  std::lock_guard<std::mutex> guard(registry_lock);
+  registry.push_back(this);
+}
+
+ring_buffer::~ring_buffer() {
+  {
+    std::lock_guard<std::mutex> guard(registry_lock);
+    registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+  }
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+  }
+  pending.notify_one();
+  writer.join();
+}
+
+void ring_buffer::write_loop() {
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    pending.wait(guard, [&]() { return stopping || flushing || written > done; });
+    if (!stopping && !flushing)
+      pending.wait_for(guard, batch_interval, [&]() { return stopping || flushing || written - done >= ring.size() / 2; });
+
+    if (written == done) {
+      flushing = false;
+      space.notify_all();
+      if (stopping) break;
+      continue;
+    }
+
+    size_t target = written;
+    size_t from = done % ring.size();
+    size_t first = std::min(target - done, ring.size() - from);
+    size_t second = (target - done) - first;
+    guard.unlock();
+    sink->sputn(ring.data() + from, static_cast<std::streamsize>(first));
+    if (second > 0) sink->sputn(ring.data(), static_cast<std::streamsize>(second));
+    sink->pubsync();
+    guard.lock();
+    done = target;
+    if (done == written) flushing = false;
+    space.notify_all();
+  }
+}
+
+std::streamsize ring_buffer::xsputn(const char *s, std::streamsize n) {
+  std::unique_lock<std::mutex> guard(lock);
+  auto left = static_cast<size_t>(n);
+  while (left > 0) {
+    if (written - done == ring.size()) {
+      pending.notify_one();
+      space.wait(guard, [&]() { return written - done < ring.size(); });
+    }
+    size_t at = written % ring.size();
+    size_t chunk = std::min({left, ring.size() - (written - done), ring.size() - at});
+    std::memcpy(ring.data() + at, s, chunk);
+    bool idle = written == done;
+    written += chunk;
+    s += chunk;
+    left -= chunk;
+    if (idle || written - done >= ring.size() / 2) pending.notify_one();
+  }
+  return n;
+}
+
+ring_buffer::int_type ring_buffer::overflow(int_type ch) {
+  if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+  char c = traits_type::to_char_type(ch);
+  xsputn(&c, 1);
+  return ch;
+}
+
+// A flush only marks the point, the writer picks it up with the next batch
+int ring_buffer::sync() { return 0; }
+
+void ring_buffer::drain() {
+  std::unique_lock<std::mutex> guard(lock);
+  if (written == done) return;
+  size_t target = written;
+  flushing = true;
+  pending.notify_one();
+  space.wait(guard, [&]() { return done >= target; });
+}
+
+buffered::buffered(std::ostream &stream, size_t capacity) : stream(stream), original(stream.rdbuf()) {
+  if (capacity == 0 || !original) return;
+  buffer = std::make_unique<ring_buffer>(original, capacity);
+  stream.rdbuf(buffer.get());
+}
+
+buffered::~buffered() {
+  if (!buffer) return;
+  stream.rdbuf(original);
+  buffer.reset();
+}
+
+void drain_all() {
+  std::lock_guard<std::mutex> guard(registry_lock);
+  for (auto *buffer : registry)
+    buffer->drain();
+}
+
+} // namespace clover::logging
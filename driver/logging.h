@@ -0,0 +1,104 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+//  @brief Console verbosity and buffered output
+//  @details The boss writes a step line (and the wall clock lines in hydro) to
+//  both clover.out and stdout every step, each ending in std::endl. With a
+//  buffered stream that flush is a write to the file or terminal, which on short
+//  steps or network filesystems shows up in the wall clock. A buffered stream
+//  copies into an in-memory ring instead and a background thread hands the ring
+//  to the real stream buffer, so a flush on the rank only wakes the writer.
+//  The level filters what reaches stdout, every filters the step lines of both.
+namespace clover::logging {
+
+enum class level { quiet, summary, step };
+
+constexpr size_t default_capacity = 1 << 20;
+
+extern thread_local level console;
+extern thread_local int every;
+
+// Sets this rank's stdout verbosity and step line interval
+void configure(level console_level, int step_interval);
+
+// Whether the step lines of this step are written at all, the first step is always shown
+inline bool step_line(int step) { return every <= 1 || step == 1 || step % every == 0; }
+
+// Whether output of the given level goes to stdout
+inline bool to_console(level l) { return console >= l; }
+
+// Stream buffer that queues into a fixed size ring drained by its own writer thread.
+// Writers block only when the ring is full, so nothing is dropped. Safe to share between threads.
+class ring_buffer final : public std::streambuf {
+public:
+  ring_buffer(std::streambuf *sink, size_t capacity);
+  ring_buffer(const ring_buffer &) = delete;
+  ring_buffer &operator=(const ring_buffer &) = delete;
+  ~ring_buffer() override;
+
+  // Blocks until everything written so far has reached the sink
+  void drain();
+
+protected:
+  int_type overflow(int_type ch) override;
+  std::streamsize xsputn(const char *s, std::streamsize n) override;
+  int sync() override;
+
+private:
+  void write_loop();
+
+  std::streambuf *sink;
+  std::vector<char> ring;
+  size_t written = 0, done = 0; // Bytes ever queued and ever handed to the sink
+  bool flushing = false, stopping = false;
+  std::mutex lock;
+  std::condition_variable pending, space;
+  std::thread writer;
+};
+
+// Routes a stream through a ring_buffer for its lifetime and restores the original buffer afterwards.
+// A capacity of 0 leaves the stream untouched.
+class buffered {
+public:
+  buffered(std::ostream &stream, size_t capacity);
+  buffered(const buffered &) = delete;
+  buffered &operator=(const buffered &) = delete;
+  ~buffered();
+
+private:
+  std::ostream &stream;
+  std::streambuf *original;
+  std::unique_ptr<ring_buffer> buffer;
+};
+
+// Drains every live ring_buffer, for paths that are about to abort the process
+void drain_all();
+
+} // namespace clover::logging
@@ -22,51 +22,233 @@
 
 #ifdef NO_MPI
 
+  #include <algorithm>
+  #include <atomic>
+  #include <cstring>
+  #include <list>
+  #include <mutex>
+  #include <thread>
+  #include <vector>
+
+namespace clover::shim {
+
+struct request {
+  std::atomic<bool> done{false};
+};
+
+namespace {
+
+// A send or receive posted by one rank that has not been matched yet
+struct pending {
+  int peer, tag;
+  void *buf;
+  size_t bytes;
+  request *req;
+};
+
+// Messages addressed to one rank, matched in posting order per peer and tag like MPI does
+struct mailbox {
+  std::mutex lock;
+  std::list<pending> sends, recvs;
+};
+
+struct world {
+  int size;
+  std::vector<mailbox> mailboxes;
+  // Sense reversing barrier
+  std::atomic<int> arrived{0};
+  std::atomic<int> generation{0};
+  // Buffers each rank publishes for the duration of a collective
+  std::vector<const void *> slots;
+  explicit world(int size) : size(size), mailboxes(size), slots(size) {}
+};
+
+world single(1);
+world *current = &single;
+thread_local int this_rank = 0;
+thread_local world self(1);
+
+// The world behind a communicator and the calling rank's place in it
+world &world_of(MPI_Comm comm) { return comm == MPI_COMM_SELF ? self : *current; }
+int rank_of(MPI_Comm comm) { return comm == MPI_COMM_SELF ? 0 : this_rank; }
+
+void barrier(world &w) {
+  if (w.size == 1) return;
+  const int generation = w.generation.load(std::memory_order_acquire);
+  if (w.arrived.fetch_add(1, std::memory_order_acq_rel) == w.size - 1) {
+    w.arrived.store(0, std::memory_order_relaxed);
+    w.generation.fetch_add(1, std::memory_order_release);
+  } else {
+    while (w.generation.load(std::memory_order_acquire) == generation)
+      std::this_thread::yield();
+  }
+}
+
+// Copies a matched pair straight from the send buffer into the receive buffer and completes both requests
+void deliver(const void *from, size_t from_bytes, void *to, size_t to_bytes, request *send, request *recv) {
+  std::memcpy(to, from, std::min(from_bytes, to_bytes));
+  send->done.store(true, std::memory_order_release);
+  recv->done.store(true, std::memory_order_release);
+}
+
+std::list<pending>::iterator find(std::list<pending> &queue, int peer, int tag) {
+  return std::find_if(queue.begin(), queue.end(), [&](const pending &p) { return p.peer == peer && p.tag == tag; });
+}
+
+template <typename T> void combine(T *into, const T *from, int count, MPI_Op op) {
+  for (int i = 0; i < count; ++i) {
+    switch (op) {
+      case MPI_SUM: into[i] += from[i]; break;
+      case MPI_MIN: into[i] = std::min(into[i], from[i]); break;
+      case MPI_MAX: into[i] = std::max(into[i], from[i]); break;
+    }
+  }
+}
+
+// Reduces over a binary combining tree: after the round with stride s, rank r holds the result of ranks r to r + 2s - 1.
+// The result ends up with rank 0 and is copied out by root, or by everyone if root is negative.
+void reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm) {
+  world &w = world_of(comm);
+  const int rank = rank_of(comm);
+  const size_t bytes = size_t(count) * datatype;
+  if (w.size == 1) {
+    std::memmove(recvbuf, sendbuf, bytes);
+    return;
+  }
+  std::vector<unsigned char> partial(static_cast<const unsigned char *>(sendbuf), static_cast<const unsigned char *>(sendbuf) + bytes);
+  w.slots[rank] = partial.data();
+  barrier(w);
+  for (int stride = 1; stride < w.size; stride *= 2) {
+    if (rank % (2 * stride) == 0 && rank + stride < w.size) {
+      const void *other = w.slots[rank + stride];
+      if (datatype == MPI_DOUBLE) combine(reinterpret_cast<double *>(partial.data()), static_cast<const double *>(other), count, op);
+      else combine(reinterpret_cast<int *>(partial.data()), static_cast<const int *>(other), count, op);
+    }
+    barrier(w);
+  }
+  if (root < 0 || root == rank) std::memcpy(recvbuf, w.slots[0], bytes);
+  barrier(w); // rank 0's partial result has to outlive every read
+}
+
+} // namespace
+
+int run(int ranks, const std::function<int()> &rank_main) {
+  if (ranks <= 1) return rank_main();
+  world w(ranks);
+  current = &w;
+  std::vector<int> codes(ranks);
+  std::vector<std::thread> threads;
+  for (int r = 1; r < ranks; ++r) {
+    threads.emplace_back([&, r]() {
+      this_rank = r;
+      codes[r] = rank_main();
+    });
+  }
+  // Rank 0 stays on the calling thread
+  codes[0] = rank_main();
+  for (auto &t : threads)
+    t.join();
+  current = &single;
+  return codes[0];
+}
+
+} // namespace clover::shim
+
+using namespace clover::shim;
+
 int MPI_Init(int *, char ***) { return MPI_SUCCESS; }
-int MPI_Comm_rank(MPI_Comm, int *rank) {
-  *rank = 0;
+int MPI_Comm_rank(MPI_Comm comm, int *rank) {
+  *rank = rank_of(comm);
   return MPI_SUCCESS;
 }
-int MPI_Comm_size(MPI_Comm, int *size) {
-  *size = 1;
+int MPI_Comm_size(MPI_Comm comm, int *size) {
+  *size = world_of(comm).size;
   return MPI_SUCCESS;
 }
 int MPI_Abort(MPI_Comm, int errorcode) {
   std::exit(errorcode);
   return MPI_SUCCESS;
 }
-int MPI_Finalize() { return MPI_SUCCESS; }
+int MPI_Finalize() {
+  // Collective, like the real one, so rank 0 can tear down process wide state afterwards
+  barrier(*current);
+  return MPI_SUCCESS;
+}
 
-int MPI_Barrier(MPI_Comm) {
-  // XXX no-op, correct for 1 rank only
+int MPI_Barrier(MPI_Comm comm) {
+  barrier(world_of(comm));
   return MPI_SUCCESS;
 }
-int MPI_Allgather(const void *, int, MPI_Datatype, void *, int, MPI_Datatype, MPI_Comm) {
-  // XXX no-op, correct for 1 rank only
+int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype,
+                  MPI_Comm comm) {
+  world &w = world_of(comm);
+  w.slots[rank_of(comm)] = sendbuf;
+  barrier(w);
+  for (int r = 0; r < w.size; ++r)
+    std::memcpy(static_cast<unsigned char *>(recvbuf) + size_t(r) * recvcount * recvtype, w.slots[r], size_t(sendcount) * sendtype);
+  barrier(w);
   return MPI_SUCCESS;
 }
-int MPI_Reduce(const void *, void *, int, MPI_Datatype, MPI_Op, int, MPI_Comm) {
-  // XXX no-op, correct for 1 rank only
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm) {
+  world &w = world_of(comm);
+  if (w.size == 1) return MPI_SUCCESS;
+  if (rank_of(comm) == root) w.slots[root] = buffer;
+  barrier(w);
+  if (rank_of(comm) != root) std::memcpy(buffer, w.slots[root], size_t(count) * datatype);
+  barrier(w);
   return MPI_SUCCESS;
 }
-int MPI_Allreduce(const void *, void *, int, MPI_Datatype, MPI_Op, MPI_Comm) {
-  // XXX no-op, correct for 1 rank only
+int MPI_Reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm) {
+  reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
   return MPI_SUCCESS;
 }
-int MPI_Waitall(int, MPI_Request[], MPI_Status[]) {
-  // XXX no-op, correct for 1 rank only
+int MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
+  reduce(sendbuf, recvbuf, count, datatype, op, -1, comm);
+  return MPI_SUCCESS;
+}
+int MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status[]) {
+  for (int i = 0; i < count; ++i) {
+    request *&req = array_of_requests[i];
+    if (!req) continue;
+    while (!req->done.load(std::memory_order_acquire))
+      std::this_thread::yield();
+    delete req;
+    req = nullptr;
+  }
   return MPI_SUCCESS;
 }
 
-int MPI_Isend(const void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *) {
-  fprintf(stderr, "MPI disabled, stub: %s\n", __func__);
-  std::abort();
-  return MPI_ERR_COMM;
+int MPI_Isend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request) {
+  world &w = world_of(comm);
+  if (dest < 0 || dest >= w.size) return MPI_ERR_COMM;
+  auto *req = new clover::shim::request;
+  *request = req;
+  const size_t bytes = size_t(count) * datatype;
+  mailbox &box = w.mailboxes[dest];
+  std::lock_guard<std::mutex> guard(box.lock);
+  if (auto recv = find(box.recvs, rank_of(comm), tag); recv != box.recvs.end()) {
+    deliver(buf, bytes, recv->buf, recv->bytes, req, recv->req);
+    box.recvs.erase(recv);
+  } else {
+    box.sends.push_back({rank_of(comm), tag, const_cast<void *>(buf), bytes, req});
+  }
+  return MPI_SUCCESS;
 }
-int MPI_Irecv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *) {
-  fprintf(stderr, "MPI disabled, stub: %s\n", __func__);
-  std::abort();
-  return MPI_ERR_COMM;
+int MPI_Irecv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request *request) {
+  world &w = world_of(comm);
+  if (source < 0 || source >= w.size) return MPI_ERR_COMM;
+  auto *req = new clover::shim::request;
+  *request = req;
+  const size_t bytes = size_t(count) * datatype;
+  mailbox &box = w.mailboxes[rank_of(comm)];
+  std::lock_guard<std::mutex> guard(box.lock);
+  if (auto send = find(box.sends, source, tag); send != box.sends.end()) {
+    deliver(send->buf, send->bytes, buf, bytes, send->req, req);
+    box.sends.erase(send);
+  } else {
+    box.recvs.push_back({source, tag, buf, bytes, req});
+  }
+  return MPI_SUCCESS;
 }
 
 #endif
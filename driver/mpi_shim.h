@@ -22,23 +22,38 @@
 #include <cstdlib>
 #ifdef NO_MPI
 
+  #include <functional>
+
+// Without MPI the ranks are threads of this process: clover::shim::run starts one thread per rank and the MPI
+// subset below is implemented in shared memory between them. With a single rank everything runs on the calling
+// thread and the calls reduce to local copies. MPI_COMM_SELF is a single rank world of the calling thread.
+
   #define MPI_SUCCESS (0)
   #define MPI_ERR_COMM (1)
   #define MPI_ERR_COUNT (2)
   #define MPI_ERR_TYPE (3)
   #define MPI_ERR_BUFFER (4)
 
-  #define MPI_INT (0)
-  #define MPI_DOUBLE (0)
+  // Datatypes are their size in bytes
+  #define MPI_INT (int(sizeof(int)))
+  #define MPI_BYTE (1)
+  #define MPI_DOUBLE (int(sizeof(double)))
   #define MPI_SUM (0)
-  #define MPI_MIN (0)
-  #define MPI_MAX (0)
+  #define MPI_MIN (1)
+  #define MPI_MAX (2)
   #define MPI_STATUS_IGNORE (0)
 
   #define MPI_COMM_WORLD (0)
+  #define MPI_COMM_SELF (1)
+
+namespace clover::shim {
+struct request;
+// Runs rank_main once on each of ranks threads and returns the exit code of rank 0
+int run(int ranks, const std::function<int()> &rank_main);
+} // namespace clover::shim
 
 using MPI_Comm = int;
-using MPI_Request = int;
+using MPI_Request = clover::shim::request *;
 using MPI_Datatype = int;
 using MPI_Op = int;
 using MPI_Status = int;
@@ -50,6 +65,7 @@ int MPI_Abort(MPI_Comm comm, int errorcode);
 int MPI_Barrier(MPI_Comm comm);
 int MPI_Finalize();
 
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm);
 int MPI_Reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm);
 int MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm);
 int MPI_Isend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request);
@@ -58,4 +74,4 @@ int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, voi
                   MPI_Comm comm);
 int MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]);
 
-#endif
\ No newline at end of file
+#endif
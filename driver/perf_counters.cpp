@@ -0,0 +1,143 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Hardware performance counters for the profiled kernels
+//  @details Each event is opened on its own rather than as a group because the
+//  kernel rejects group reads on inherited events. Values are scaled by
+//  time_enabled / time_running so multiplexed events stay comparable.
+
+#include "perf_counters.h"
+#include "logging.h"
+
+#include <array>
+#include <cstring>
+#include <iomanip>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+extern thread_local std::ostream g_out;
+
+namespace clover::counters {
+
+thread_local bool enabled = false;
+
+namespace {
+
+enum event { cycles, instructions, llc_misses, stall_cycles, event_count };
+
+struct reading {
+  uint64_t value, time_enabled, time_running;
+};
+
+thread_local std::array<int, event_count> fds = {-1, -1, -1, -1};
+thread_local std::array<std::array<double, event_count>, region_count> snapshot{};
+thread_local std::array<std::array<double, event_count>, region_count> totals{};
+thread_local std::array<uint64_t, region_count> calls{};
+
+int open_event(uint32_t type, uint64_t config) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+double read_event(int fd) {
+  reading r{};
+  if (fd < 0 || read(fd, &r, sizeof(r)) != sizeof(r) || r.time_running == 0) return 0.0;
+  return static_cast<double>(r.value) * (static_cast<double>(r.time_enabled) / static_cast<double>(r.time_running));
+}
+
+void read_all(std::array<double, event_count> &values) {
+  for (int e = 0; e < event_count; ++e)
+    values[e] = read_event(fds[e]);
+}
+
+} // namespace
+
+void record_begin(region r) { read_all(snapshot[r]); }
+
+void record_end(region r) {
+  std::array<double, event_count> now{};
+  read_all(now);
+  for (int e = 0; e < event_count; ++e)
+    totals[r][e] += now[e] - snapshot[r][e];
+  calls[r]++;
+}
+
+bool start(bool silent) {
+  fds[cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  if (fds[cycles] < 0) {
+    if (!silent) std::cout << "# WARNING: perf_event_open failed (" << std::strerror(errno) << "), hardware counters disabled" << std::endl;
+    return false;
+  }
+  fds[instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  fds[llc_misses] = open_event(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+  // Not every PMU exposes a last level cache event, the generic cache miss event is the closest substitute
+  if (fds[llc_misses] < 0) fds[llc_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  fds[stall_cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND);
+  enabled = true;
+  return true;
+}
+
+void report(global_variables &globals, parallel_ &parallel) {
+  if (!enabled) return;
+
+  const double cells = static_cast<double>(globals.chunk.x_max - globals.chunk.x_min + 1) * (globals.chunk.y_max - globals.chunk.y_min + 1);
+  std::array<std::array<double, event_count>, region_count> sums = totals;
+  std::array<double, region_count> cell_updates{};
+  for (int r = 0; r < region_count; ++r) {
+    for (int e = 0; e < event_count; ++e)
+      clover_sum(sums[r][e]);
+    cell_updates[r] = static_cast<double>(calls[r]) * cells;
+    clover_sum(cell_updates[r]);
+  }
+  if (!parallel.boss) return;
+
+  const std::array<const char *, region_count> names = {
+      " Ideal Gas             :", " Viscosity             :", " PdV                   :", " Acceleration          :",
+      " Fluxes                :", " Cell Advection        :", " Momentum Advection    :", " Reset                 :",
+  };
+  auto na = [](int e) { return fds[e] < 0; };
+  auto writeCounters = [&](auto &stream) {
+    stream << std::fixed << std::setprecision(3) << std::endl
+           << " Hardware Counters      IPC    LLC miss/cell  Stall frac  Cycles/cell" << std::endl;
+    for (int r = 0; r < region_count; ++r) {
+      const auto &s = sums[r];
+      stream << names[r] << std::setw(6) << (s[cycles] > 0 ? s[instructions] / s[cycles] : 0.0) << " ";
+      if (na(llc_misses)) stream << std::setw(14) << "n/a";
+      else stream << std::setw(14) << (cell_updates[r] > 0 ? s[llc_misses] / cell_updates[r] : 0.0);
+      if (na(stall_cycles)) stream << std::setw(12) << "n/a";
+      else stream << std::setw(12) << (s[cycles] > 0 ? s[stall_cycles] / s[cycles] : 0.0);
+      stream << std::setw(13) << (cell_updates[r] > 0 ? s[cycles] / cell_updates[r] : 0.0) << std::endl;
+    }
+    stream << std::endl;
+  };
+  writeCounters(g_out);
+  if (clover::logging::to_console(clover::logging::level::summary)) writeCounters(std::cout);
+}
+
+} // namespace clover::counters
@@ -0,0 +1,56 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "comms.h"
+#include "definitions.h"
+
+//  @brief Hardware performance counters for the profiled kernels
+//  @details Uses Linux perf_event_open to count cycles, instructions, last level
+//  cache misses and backend (memory) stall cycles around the main kernels, so a
+//  kernel can be classified as bandwidth or latency bound. Counters are opened
+//  with inherit set, so they cover the calling thread and every thread it spawns
+//  afterwards; start() must therefore run before the first parallel region.
+//  Only host execution is counted, for offload models the numbers describe the
+//  driver side of the kernel launches. The state is per thread, so ranks running
+//  as threads of one process (see mpi_shim.h) each count their own work.
+namespace clover::counters {
+
+enum region { ideal_gas, viscosity, PdV, accelerate, flux_calc, advec_cell, advec_mom, reset_field, region_count };
+
+extern thread_local bool enabled;
+
+void record_begin(region r);
+void record_end(region r);
+
+inline void begin(region r) {
+  if (enabled) record_begin(r);
+}
+inline void end(region r) {
+  if (enabled) record_end(r);
+}
+
+// Opens the counters, returns false (and leaves counting disabled) if the kernel refuses
+bool start(bool silent);
+
+// Sums counters over all ranks and prints IPC and per cell figures on the boss, must be called on every rank
+void report(global_variables &globals, parallel_ &parallel);
+
+} // namespace clover::counters
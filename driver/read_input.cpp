@@ -32,14 +32,12 @@
 #include <iterator>
 #include <sstream>
 
-extern std::ostream g_out;
+extern thread_local std::ostream g_out;
 
-void read_input(std::ifstream &g_in, parallel_ &parallel, global_config &globals) {
+void read_input_defaults(global_config &globals) {
 
   globals.test_problem = 0;
 
-  int state_max = 0;
-
   globals.grid.xmin = 0.0;
   globals.grid.ymin = 0.0;
   globals.grid.xmax = 0.0;
@@ -54,6 +52,7 @@ void read_input(std::ifstream &g_in, parallel_ &parallel, global_config &globals
 
   globals.visit_frequency = 0;
   globals.summary_frequency = 10;
+  globals.warmup_steps = 1;
 
   globals.tiles_per_chunk = 1;
 
@@ -84,6 +83,13 @@ void read_input(std::ifstream &g_in, parallel_ &parallel, global_config &globals
   //	globals.profiler.tile_halo_exchange = 0.0;
   //	globals.profiler.self_halo_exchange = 0.0;
   //	globals.profiler.mpi_halo_exchange = 0.0;
+}
+
+void read_input(std::istream &g_in, parallel_ &parallel, global_config &globals) {
+
+  read_input_defaults(globals);
+
+  int state_max = 0;
 
   if (parallel.boss) {
     g_out << "Reading input file" << std::endl << std::endl;
@@ -178,6 +184,12 @@ void read_input(std::ifstream &g_in, parallel_ &parallel, global_config &globals
     } else if (words[0] == "summary_frequency") {
       globals.summary_frequency = std::stoi(words[1]);
       if (parallel.boss) g_out << " summary_frequency " << globals.summary_frequency << std::endl;
+    } else if (words[0] == "warmup_steps") {
+      globals.warmup_steps = std::stoi(words[1]);
+      if (parallel.boss) g_out << " warmup_steps " << globals.warmup_steps << std::endl;
+    } else if (words[0] == "tiles_per_chunk" && words[1] == "auto") {
+      globals.tiles_per_chunk = 0;
+      if (parallel.boss) g_out << " tiles_per_chunk auto" << std::endl;
     } else if (words[0] == "tiles_per_chunk") {
       globals.tiles_per_chunk = std::stoi(words[1]);
       if (parallel.boss) g_out << " tiles_per_chunk " << globals.tiles_per_chunk << std::endl;
@@ -258,20 +270,4 @@ void read_input(std::ifstream &g_in, parallel_ &parallel, global_config &globals
   if (parallel.boss) {
     g_out << std::endl << std::endl << "Input read finished." << std::endl << std::endl;
   }
-
-  // If a state boundary falls exactly on a cell boundary then round off can
-  // cause the state to be put one cell further that expected. This is compiler
-  // /system dependent. To avoid this, a state boundary is reduced/increased by a 100th
-  // of a cell width so it lies well with in the intended cell.
-  // Because a cell is either full or empty of a specified state, this small
-  // modification to the state extents does not change the answers.
-  double dx, dy;
-  dx = (globals.grid.xmax - globals.grid.xmin) / (float)globals.grid.x_cells;
-  dy = (globals.grid.ymax - globals.grid.ymin) / (float)globals.grid.y_cells;
-  for (int n = 1; n < globals.number_of_states; ++n) {
-    globals.states[n].xmin += dx / 100.0;
-    globals.states[n].ymin += dy / 100.0;
-    globals.states[n].xmax -= dx / 100.0;
-    globals.states[n].ymax -= dy / 100.0;
-  }
 }
@@ -24,4 +24,7 @@
 #include "comms.h"
 #include "definitions.h"
 
-void read_input(std::ifstream &g_in, parallel_ &parallel, global_config &globals);
+// The values of everything a deck may leave out
+void read_input_defaults(global_config &globals);
+
+void read_input(std::istream &g_in, parallel_ &parallel, global_config &globals);
@@ -62,6 +62,7 @@ void clover_report_step_header(global_variables &globals, parallel_ &parallel) {
 
 void clover_report_step(global_variables &globals, parallel_ &parallel, //
                         double vol, double mass, double ie, double ke, double press) {
+  globals.summary = {vol, mass, ie, ke, press};
   if (parallel.boss) {
     auto formatting = g_out.flags();
     g_out << " step: " << globals.step << std::scientific << std::setw(15) << vol << std::scientific << std::setw(15) << mass
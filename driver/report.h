@@ -22,7 +22,7 @@
 #include "definitions.h"
 #include <cmath>
 
-extern std::ostream g_out;
+extern thread_local std::ostream g_out;
 
 void report_error(char *location, char *error);
 
@@ -0,0 +1,174 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Bitwise reproducible field summaries
+//  @details A double is m * 2^(e - 53) with |m| < 2^53, so shifted into place
+//  it spans at most three 32 bit digits. The digits are 64 bit integers and
+//  each add puts less than 2^33 into one, so 2^29 adds can be absorbed before
+//  the carries have to be pushed up. Across ranks the normalised digits are
+//  reduced as doubles: each is an integer below 2^32, so their sums stay
+//  exact (and order independent) well past any realistic rank count.
+
+#include "reproducible.h"
+#include "field_view.h"
+
+#include <cmath>
+#include <vector>
+
+namespace clover::repro {
+
+namespace {
+
+constexpr std::int64_t base = std::int64_t(1) << accumulator::digit_bits;
+constexpr std::int64_t digit_mask = base - 1;
+constexpr int lsb_exponent = -1127; // Weight of bit 0 of digit 0, see accumulator::add
+constexpr std::int64_t renormalise_after = std::int64_t(1) << 29;
+
+// Floor division by the digit base, so negative digits carry downwards like positive ones carry up
+std::int64_t carry_of(std::int64_t d) { return d >= 0 ? d / base : -((-d + base - 1) / base); }
+
+} // namespace
+
+void accumulator::add(double x) {
+  if (x == 0.0) return;
+  int e;
+  auto m = static_cast<std::int64_t>(std::ldexp(std::frexp(x, &e), 53));
+  // x = m * 2^(e - 53) and bit p of the digits weighs 2^(p - 1127), so m's lowest bit lands at bit e + 1074 >= 1
+  int p = e + 1074;
+  int d = p / digit_bits, shift = p % digit_bits;
+  auto u = static_cast<std::uint64_t>(m < 0 ? -m : m);
+  std::uint64_t lo = (u & digit_mask) << shift, hi = (u >> digit_bits) << shift;
+  auto d0 = static_cast<std::int64_t>(lo & digit_mask);
+  auto d1 = static_cast<std::int64_t>((lo >> digit_bits) + (hi & digit_mask));
+  auto d2 = static_cast<std::int64_t>(hi >> digit_bits);
+  if (m < 0) {
+    d0 = -d0, d1 = -d1, d2 = -d2;
+  }
+  digit[d] += d0;
+  digit[d + 1] += d1;
+  digit[d + 2] += d2;
+  if (++pending == renormalise_after) normalise();
+}
+
+void accumulator::normalise() {
+  for (int i = 0; i < digits - 1; ++i) {
+    std::int64_t carry = carry_of(digit[i]);
+    digit[i] -= carry * base;
+    digit[i + 1] += carry;
+  }
+  pending = 0;
+}
+
+std::array<double, accumulator::digits> accumulator::to_doubles() {
+  normalise();
+  std::array<double, digits> values{};
+  for (int i = 0; i < digits; ++i)
+    values[i] = static_cast<double>(digit[i]);
+  return values;
+}
+
+accumulator accumulator::from_doubles(const double *values) {
+  accumulator acc;
+  for (int i = 0; i < digits; ++i)
+    acc.digit[i] = static_cast<std::int64_t>(values[i]);
+  return acc;
+}
+
+double accumulator::value() {
+  normalise();
+  // Sign and magnitude, so every digit is in [0, 2^32) and the top nonzero one leads
+  bool negative = digit[digits - 1] < 0;
+  if (negative) {
+    for (auto &d : digit)
+      d = -d;
+    normalise();
+  }
+  int top = digits - 1;
+  while (top >= 0 && digit[top] == 0)
+    --top;
+  if (top < 0) return 0.0;
+
+  // The top digit and the 64 bits below it, at least 65 bits in all, and whether anything lower is set
+  auto at = [&](int i) { return i >= 0 ? static_cast<std::uint64_t>(digit[i]) : std::uint64_t(0); };
+  std::uint64_t hi = at(top), lo = (at(top - 1) << digit_bits) | at(top - 2);
+  bool sticky = false;
+  for (int i = 0; i < top - 2; ++i)
+    sticky = sticky || digit[i] != 0;
+  int hi_bits = 0;
+  while (hi >> hi_bits)
+    ++hi_bits;
+
+  // Keep the leading 53 bits and round the dropped ones to nearest, ties to even. Every input is a multiple of
+  // 2^-1074, so a sum below the normal range has no bits to drop and ldexp places it exactly.
+  int dropped = hi_bits + 64 - 53; // In [12, 43]
+  std::uint64_t mantissa = (hi << (64 - dropped)) | (lo >> dropped);
+  std::uint64_t rest = lo & ((std::uint64_t(1) << dropped) - 1), half = std::uint64_t(1) << (dropped - 1);
+  if (rest > half || (rest == half && (sticky || (mantissa & 1)))) ++mantissa;
+  double sum = std::ldexp(static_cast<double>(mantissa), dropped + digit_bits * (top - 2) + lsb_exponent);
+  return negative ? -sum : sum;
+}
+
+void field_summary(global_variables &globals, double &vol, double &mass, double &ie, double &ke, double &press) {
+  enum { t_vol, t_mass, t_ie, t_ke, t_press, totals };
+  accumulator acc[totals];
+
+  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
+    tile_type &t = globals.chunk.tiles[tile];
+    // Only the layout is needed, the values come from the host copies
+    clover::field_view cells = clover_field_view(globals, tile, field_density0);
+    clover::field_view nodes = clover_field_view(globals, tile, field_xvel0);
+    std::vector<double> volume = clover_field_host(globals, t.field.volume), density0 = clover_field_host(globals, t.field.density0),
+                        energy0 = clover_field_host(globals, t.field.energy0), pressure = clover_field_host(globals, t.field.pressure),
+                        xvel0 = clover_field_host(globals, t.field.xvel0), yvel0 = clover_field_host(globals, t.field.yvel0);
+
+    // Same cells and the same per cell arithmetic as the model kernels, only the summation differs
+    for (int k = t.info.t_ymin + 1; k < t.info.t_ymax + 2; ++k) {
+      for (int j = t.info.t_xmin + 1; j < t.info.t_xmax + 2; ++j) {
+        double vsqrd = 0.0;
+        for (int kv = k; kv <= k + 1; ++kv) {
+          for (int jv = j; jv <= j + 1; ++jv) {
+            std::ptrdiff_t n = jv * nodes.x_stride + kv * nodes.y_stride;
+            vsqrd += 0.25 * (xvel0[n] * xvel0[n] + yvel0[n] * yvel0[n]);
+          }
+        }
+        std::ptrdiff_t c = j * cells.x_stride + k * cells.y_stride;
+        double cell_vol = volume[c];
+        double cell_mass = cell_vol * density0[c];
+        acc[t_vol].add(cell_vol);
+        acc[t_mass].add(cell_mass);
+        acc[t_ie].add(cell_mass * energy0[c]);
+        acc[t_ke].add(cell_mass * 0.5 * vsqrd);
+        acc[t_press].add(cell_vol * pressure[c]);
+      }
+    }
+  }
+
+  std::vector<double> packed(totals * accumulator::digits);
+  for (int i = 0; i < totals; ++i) {
+    auto values = acc[i].to_doubles();
+    std::copy(values.begin(), values.end(), packed.begin() + i * accumulator::digits);
+  }
+  clover_sum(packed);
+
+  double *result[totals] = {&vol, &mass, &ie, &ke, &press};
+  for (int i = 0; i < totals; ++i)
+    *result[i] = accumulator::from_doubles(packed.data() + i * accumulator::digits).value();
+}
+
+} // namespace clover::repro
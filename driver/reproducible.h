@@ -0,0 +1,70 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "comms.h"
+#include "definitions.h"
+
+#include <array>
+#include <cstdint>
+
+//  @brief Bitwise reproducible field summaries
+//  @details The model reductions add in whatever order the threads, tiles and
+//  ranks happen to produce, so the last bits of a summary change with the
+//  decomposition. In this mode every cell's contribution goes into an exact
+//  fixed point accumulator instead: integer addition is associative, so the
+//  total is the same for any thread count, tile split or rank count, and is
+//  rounded to double only once at the end. The fields are read back through
+//  each model's clover_field_host (field_view.h), which copies them from the
+//  device where that holds the current copy, at the cost of copying six
+//  fields per tile per summary. Minimum reductions (calc_dt) are
+//  exact in any order already and need nothing here.
+namespace clover::repro {
+
+// Holds a sum of doubles exactly, as signed 32 bit digits over the whole exponent range of double.
+// Digit i weighs 2^(32 i - 1127); each add touches three digits, and the digits are renormalised before they
+// could overflow, so any number of values can be added.
+class accumulator {
+public:
+  static constexpr int digit_bits = 32;
+  static constexpr int digits = 70;
+
+  void add(double x);
+
+  // Carries so that every digit but the top one is in [0, 2^32), the form the digits are reduced in
+  void normalise();
+
+  // The normalised digits, which are exact as doubles, and sum exactly over up to 2^21 ranks in any order
+  std::array<double, digits> to_doubles();
+  static accumulator from_doubles(const double *values);
+
+  // The exact sum rounded to the nearest double, ties to even
+  [[nodiscard]] double value();
+
+private:
+  std::array<std::int64_t, digits> digit{};
+  std::int64_t pending = 0;
+};
+
+// Replaces vol, mass, ie, ke and press with the exactly summed totals of every rank, only the boss holds the result
+// like clover_sum. Must be called on every rank, after the model's ideal_gas update of the summary.
+void field_summary(global_variables &globals, double &vol, double &mass, double &ie, double &ke, double &press);
+
+} // namespace clover::repro
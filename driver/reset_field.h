@@ -21,4 +21,10 @@
 
 #include "definitions.h"
 
+// With globals.fused.due, models that support it also run the ideal gas update of the new level 0 fields and take
+// the field summary sums in the same pass over the cells, into globals.fused, so the summary that follows need not
+// read the fields again (--fused-summary).
 void reset_field(global_variables &globals);
+
+// Whether this model's reset_field can take the field summary sums
+bool fused_summary_supported();
@@ -0,0 +1,210 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
+//  @brief Minimal fixed width vector of doubles for explicit SIMD kernels
+//  @details A vec holds one native register worth of doubles and every
+//  operation is a constant trip count loop over its lanes, which GCC, Clang and
+//  the Intel compilers turn into single vector instructions at -O2 and above.
+//  Comparisons give a mask and select() is the blend, so data dependent choices
+//  become straight line code. The same operations are overloaded for plain
+//  double (with bool as the mask), so a kernel written as a template over the
+//  lane type serves both the vector body and the scalar remainder of a loop.
+//  std::experimental::simd would do the same, but is only shipped by
+//  libstdc++ and not by every compiler the host models are built with.
+namespace clover::simd {
+
+#if defined(__AVX512F__)
+inline constexpr int width = 8;
+#elif defined(__AVX__)
+inline constexpr int width = 4;
+#else
+inline constexpr int width = 2; // SSE2, NEON, or left to the compiler
+#endif
+
+struct mask {
+  std::int64_t lane[width];
+};
+
+struct vec {
+  double lane[width];
+  vec() = default;
+  vec(double x) { // Implicit, so literals mix with vectors the way they do with double
+    for (int l = 0; l < width; ++l)
+      lane[l] = x;
+  }
+};
+
+inline vec load(const double *p) {
+  vec r;
+  for (int l = 0; l < width; ++l)
+    r.lane[l] = p[l];
+  return r;
+}
+
+inline void store(double *p, const vec &a) {
+  for (int l = 0; l < width; ++l)
+    p[l] = a.lane[l];
+}
+
+#define CLOVER_SIMD_BINARY(op)                                                                                                             \
+  inline vec operator op(const vec &a, const vec &b) {                                                                                     \
+    vec r;                                                                                                                                 \
+    for (int l = 0; l < width; ++l)                                                                                                        \
+      r.lane[l] = a.lane[l] op b.lane[l];                                                                                                  \
+    return r;                                                                                                                              \
+  }
+CLOVER_SIMD_BINARY(+)
+CLOVER_SIMD_BINARY(-)
+CLOVER_SIMD_BINARY(*)
+CLOVER_SIMD_BINARY(/)
+#undef CLOVER_SIMD_BINARY
+
+inline vec operator-(const vec &a) {
+  vec r;
+  for (int l = 0; l < width; ++l)
+    r.lane[l] = -a.lane[l];
+  return r;
+}
+
+#define CLOVER_SIMD_COMPARE(op)                                                                                                            \
+  inline mask operator op(const vec &a, const vec &b) {                                                                                    \
+    mask r;                                                                                                                                \
+    for (int l = 0; l < width; ++l)                                                                                                        \
+      r.lane[l] = a.lane[l] op b.lane[l] ? -1 : 0;                                                                                         \
+    return r;                                                                                                                              \
+  }
+CLOVER_SIMD_COMPARE(<)
+CLOVER_SIMD_COMPARE(<=)
+CLOVER_SIMD_COMPARE(>)
+#undef CLOVER_SIMD_COMPARE
+
+inline vec select(const mask &m, const vec &a, const vec &b) {
+  vec r;
+  for (int l = 0; l < width; ++l)
+    r.lane[l] = m.lane[l] ? a.lane[l] : b.lane[l];
+  return r;
+}
+
+inline vec abs(const vec &a) {
+  vec r;
+  for (int l = 0; l < width; ++l)
+    r.lane[l] = std::fabs(a.lane[l]);
+  return r;
+}
+
+// std::sqrt may set errno, which keeps a lane loop of it scalar, so this goes through the intrinsics where there are some
+inline vec sqrt(const vec &a) {
+  vec r;
+#if defined(__AVX512F__)
+  __m512d x = _mm512_loadu_pd(a.lane);
+  _mm512_storeu_pd(r.lane, _mm512_mask_sqrt_pd(x, 0xFF, x)); // the unmasked form trips GCC 12's -Wuninitialized
+#elif defined(__AVX__)
+  _mm256_storeu_pd(r.lane, _mm256_sqrt_pd(_mm256_loadu_pd(a.lane)));
+#elif defined(__SSE2__)
+  _mm_storeu_pd(r.lane, _mm_sqrt_pd(_mm_loadu_pd(a.lane)));
+#else
+  for (int l = 0; l < width; ++l)
+    r.lane[l] = std::sqrt(a.lane[l]);
+#endif
+  return r;
+}
+
+// Same result as std::fmin for the non-NaN values the kernels see, but without the call
+inline vec min(const vec &a, const vec &b) {
+  vec r;
+  for (int l = 0; l < width; ++l)
+    r.lane[l] = b.lane[l] < a.lane[l] ? b.lane[l] : a.lane[l];
+  return r;
+}
+
+// The scalar lane type, for remainders
+inline double select(bool m, double a, double b) { return m ? a : b; }
+inline double abs(double a) { return std::fabs(a); }
+inline double min(double a, double b) { return b < a ? b : a; }
+inline double sqrt(double a) { return std::sqrt(a); }
+
+// Loads and stores that work for either lane type
+template <typename T> T load_as(const double *p);
+template <> inline double load_as<double>(const double *p) { return *p; }
+template <> inline vec load_as<vec>(const double *p) { return load(p); }
+inline void store(double *p, double a) { *p = a; }
+
+// Non-temporal store: the line goes to memory without being read for ownership first or kept in cache, which saves
+// a third of the traffic of an output that is only written. Needs a vector aligned p, anything else is a plain store
+inline void stream(double *p, const vec &a) {
+  if (reinterpret_cast<std::uintptr_t>(p) % sizeof(vec) != 0) return store(p, a);
+#if defined(__AVX512F__)
+  _mm512_stream_pd(p, _mm512_loadu_pd(a.lane));
+#elif defined(__AVX__)
+  _mm256_stream_pd(p, _mm256_loadu_pd(a.lane));
+#elif defined(__SSE2__)
+  _mm_stream_pd(p, _mm_loadu_pd(a.lane));
+#elif defined(__clang__)
+  for (int l = 0; l < width; ++l)
+    __builtin_nontemporal_store(a.lane[l], p + l);
+#else
+  store(p, a);
+#endif
+}
+inline void stream(double *p, double a) { *p = a; }
+
+// Streamed stores are weakly ordered, so a thread has to fence them before another may read what it wrote
+inline void stream_fence() {
+#if defined(__SSE2__)
+  _mm_sfence();
+#endif
+}
+
+// Runs f(i, lane) over [begin, end) of a row, with double lanes up to the first i for which out + i is vector aligned,
+// then whole vecs, then double lanes for the remainder. Outputs with the same row stride and base alignment as out
+// are then aligned for every vec as well
+template <typename F> inline void aligned_row(const double *out, int begin, int end, F &&f) {
+  int i = begin;
+  for (; i < end && reinterpret_cast<std::uintptr_t>(out + i) % sizeof(vec) != 0; ++i)
+    f(i, double{});
+  for (; i + width <= end; i += width)
+    f(i, vec{});
+  for (; i < end; ++i)
+    f(i, double{});
+}
+
+// Row loop of a kernel that streams its outputs: rows [y_begin, y_end) are shared out between the threads like an
+// omp for would, each row goes through aligned_row on out + j * stride, and every thread fences before the region ends
+template <typename F>
+inline void stream_rows(const double *out, std::ptrdiff_t stride, int x_begin, int x_end, int y_begin, int y_end, F &&f) {
+#pragma omp parallel
+  {
+#pragma omp for
+    for (int j = y_begin; j < y_end; j++)
+      aligned_row(out + j * stride, x_begin, x_end, [&](int i, auto lane) { f(i, j, lane); });
+    stream_fence();
+  }
+}
+
+} // namespace clover::simd
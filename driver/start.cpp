@@ -25,22 +25,24 @@
 //  pressure before priming the halo cells and writing an initial field summary.
 
 #include <algorithm>
+#include <iostream>
 #include <sstream>
 #include <string>
 
+#include "arena.h"
 #include "build_field.h"
 #include "comms_kernel.h"
+#include "dirty.h"
 #include "field_summary.h"
 #include "generate_chunk.h"
-#include "ideal_gas.h"
+#include "huge_pages.h"
 #include "initialise_chunk.h"
 #include "start.h"
-#include "update_halo.h"
 #include "visit.h"
 
-extern std::ostream g_out;
+extern thread_local std::ostream g_out;
 
-global_variables start(parallel_ &parallel, const global_config &config, clover::context ctx) {
+global_variables start(parallel_ &parallel, global_config config, clover::context ctx) {
 
   if (parallel.boss) {
     g_out << "Setting up initial geometry" << std::endl << std::endl;
@@ -49,21 +51,61 @@ global_variables start(parallel_ &parallel, const global_config &config, clover:
   clover_barrier();
 
   int left, right, bottom, top;
-  auto chunkNeighbours = clover_decompose(config, parallel, config.grid.x_cells, config.grid.y_cells, left, right, bottom, top);
+  std::vector<int> chunkTasks;
+  auto chunkNeighbours = clover_decompose(config, parallel, config.grid.x_cells, config.grid.y_cells, left, right, bottom, top, chunkTasks);
+
+  int chunk_x_cells = right - left + 1;
+  int chunk_y_cells = top - bottom + 1;
+  clover::tiling::layout layout{};
+  if (config.tiles_per_chunk > 0) {
+    layout = clover::tiling::factorise(config.tiles_per_chunk, chunk_x_cells, chunk_y_cells);
+  } else {
+    // Every rank has to arrive at the same layout, so it is chosen for the largest chunk and the smallest caches of any rank
+    clover::tiling::caches sizes = clover::tiling::detect();
+    double largest_x = -chunk_x_cells, largest_y = -chunk_y_cells, l2 = double(sizes.l2), llc = double(sizes.llc);
+    clover_min(largest_x);
+    clover_min(largest_y);
+    clover_min(l2);
+    clover_min(llc);
+    sizes = {std::size_t(l2), std::size_t(llc)};
+    // Without MPI the ranks are threads of this process and share its LLC
+#ifdef NO_MPI
+    int ranks_sharing = parallel.max_task;
+#else
+    int ranks_sharing = 1;
+#endif
+    layout = clover::tiling::choose(int(-largest_x), int(-largest_y), sizes, ranks_sharing);
+    config.tiles_per_chunk = layout.tiles_x * layout.tiles_y;
+    if (parallel.boss) {
+      int nx = clover::tiling::split(int(-largest_x), layout.tiles_x, layout.align).front();
+      int ny = clover::tiling::split(int(-largest_y), layout.tiles_y, 1).front();
+      g_out << "Automatic tiling for a " << (sizes.l2 >> 10) << " KiB L2 and " << (sizes.llc >> 10) << " KiB LLC: " << layout.tiles_x
+            << " by " << layout.tiles_y << " tiles of up to " << nx << " by " << ny << " cells, "
+            << (clover::tiling::working_set(nx, ny) >> 10) << " KiB per kernel" << std::endl
+            << std::endl;
+    }
+  }
 
-  // Create the chunks
+  // Visit dumps write cells outside the interior of the level 0 and derived fields, which an aliased arena leaves
+  // holding advection's work arrays between steps. The banner went out before the deck was read, so warn here.
+  if (config.arena == arena_type::aliased && config.visit_frequency != 0) {
+    if (parallel.boss) {
+      std::cout << " WARNING: --arena aliased is not available with visit_frequency, using packed" << std::endl;
+      g_out << " WARNING: --arena aliased is not available with visit_frequency, using packed" << std::endl << std::endl;
+    }
+    config.arena = arena_type::packed;
+  }
 
-  int x_cells = right - left + 1;
-  int y_cells = top - bottom + 1;
+  // Create the chunks
 
   global_variables globals(config, ctx,
-                           chunk_type(chunkNeighbours, parallel.task, 1, 1, x_cells, y_cells, left, right, bottom, top, 1,
-                                      config.grid.x_cells, 1, config.grid.y_cells, config.tiles_per_chunk));
+                           chunk_type(chunkNeighbours, chunkTasks, parallel.task, 1, 1, chunk_x_cells, chunk_y_cells, left, right, bottom,
+                                      top, 1, config.grid.x_cells, 1, config.grid.y_cells, config.tiles_per_chunk));
 
-  auto infos = clover_tile_decompose(globals, x_cells, y_cells);
+  auto infos = clover_tile_decompose(globals, chunk_x_cells, chunk_y_cells, layout);
 
   std::transform(infos.begin(), infos.end(), std::back_inserter(globals.chunk.tiles),
-                 [&](const tile_info &ti) { return tile_type(ti, globals.context); });
+                 [&](const tile_info &ti) { return tile_type(ti, globals.context, config.arena); });
 
   // Line 92 start.f90
   build_field(globals);
@@ -82,6 +124,7 @@ global_variables start(parallel_ &parallel, const global_config &config, clover:
     initialise_chunk(tile, globals);
     generate_chunk(tile, globals);
   }
+  clover::dirty::primary_written(globals);
   if (!globals.config.dumpDir.empty())
     clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_01_generate_chunk.txt");
 
@@ -92,9 +135,7 @@ global_variables start(parallel_ &parallel, const global_config &config, clover:
   bool profiler_off = globals.profiler_on;
   globals.profiler_on = false;
 
-  for (int tile = 0; tile < config.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
-  }
+  clover::dirty::ideal_gas(globals);
   if (!globals.config.dumpDir.empty())
     clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_02_ideal_gas.txt");
 
@@ -115,7 +156,7 @@ global_variables start(parallel_ &parallel, const global_config &config, clover:
   fields[field_xvel1] = 1;
   fields[field_yvel1] = 1;
 
-  update_halo(globals, fields, 2);
+  clover::dirty::update_halo(globals, fields, 2);
   if (!globals.config.dumpDir.empty())
     clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_03_update_halo.txt");
 
@@ -128,6 +169,10 @@ global_variables start(parallel_ &parallel, const global_config &config, clover:
   if (!globals.config.dumpDir.empty())
     clover::dump(globals, std::to_string(parallel.task) + "_" + std::to_string(globals.step) + "_04_field_summary.txt");
 
+  // After the initialisation has touched the fields, so advised pages had their chance to be collapsed
+  clover::pages::report(parallel, g_out);
+  clover::arena::report(globals, parallel, g_out);
+
   if (config.visit_frequency != 0) visit(globals, parallel);
 
   clover_barrier(globals);
@@ -22,4 +22,4 @@
 #include "comms.h"
 #include "definitions.h"
 
- global_variables start(parallel_ &parallel, const global_config &config, clover::context ctx);
+ global_variables start(parallel_ &parallel, global_config config, clover::context ctx);
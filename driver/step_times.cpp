@@ -0,0 +1,124 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Steady-state step time statistics
+//  @details Percentiles use the nearest rank method on the sorted series, which is
+//  exact for the short runs typical here and never interpolates between steps.
+
+#include "step_times.h"
+#include "logging.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+extern thread_local std::ostream g_out;
+
+namespace clover::steps {
+
+namespace {
+
+struct moments {
+  double mean, stddev;
+};
+
+moments moments_of(const std::vector<double> &xs) {
+  if (xs.empty()) return {0.0, 0.0};
+  double mean = std::accumulate(xs.begin(), xs.end(), 0.0) / double(xs.size());
+  double sq = 0.0;
+  for (double x : xs)
+    sq += (x - mean) * (x - mean);
+  return {mean, std::sqrt(sq / double(xs.size()))};
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+  auto rank = static_cast<size_t>(std::ceil(p / 100.0 * double(sorted.size())));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+} // namespace
+
+void report(const global_variables &globals, const parallel_ &parallel, const std::vector<double> &times) {
+
+  size_t warmup = std::min(static_cast<size_t>(std::max(globals.config.warmup_steps, 0)), times.size());
+  std::vector<double> local(times.begin() + std::ptrdiff_t(warmup), times.end());
+
+  // Every rank takes the same number of steps, so the series line up element-wise
+  std::vector<double> slowest = local;
+  clover_max(slowest);
+
+  std::vector<double> rank_jitter(parallel.max_task);
+  clover_allgather(moments_of(local).stddev, rank_jitter);
+
+  if (!parallel.boss) return;
+
+  if (slowest.empty()) {
+    auto writeNone = [&](auto &stream) {
+      stream << std::endl << " Steady state: no steps after the " << warmup << " warmup step(s)" << std::endl;
+    };
+    writeNone(g_out);
+    if (clover::logging::to_console(clover::logging::level::summary)) writeNone(std::cout);
+    return;
+  }
+
+  std::vector<double> sorted = slowest;
+  std::sort(sorted.begin(), sorted.end());
+  auto [mean, stddev] = moments_of(sorted);
+  double lo = sorted.front(), hi = sorted.back();
+  double cells = double(globals.config.grid.x_cells) * double(globals.config.grid.y_cells);
+
+  auto quiet = std::min_element(rank_jitter.begin(), rank_jitter.end());
+  auto noisy = std::max_element(rank_jitter.begin(), rank_jitter.end());
+
+  constexpr int bins = 10;
+  std::vector<int> histogram(bins, 0);
+  for (double t : sorted) {
+    int bin = hi > lo ? static_cast<int>(double(bins) * (t - lo) / (hi - lo)) : 0;
+    histogram[std::min(bin, bins - 1)]++;
+  }
+  int tallest = *std::max_element(histogram.begin(), histogram.end());
+
+  auto writeSteps = [&](auto &stream) {
+    stream << std::scientific << std::setprecision(4) << std::endl
+           << " Steady state            " << sorted.size() << " steps after " << warmup << " warmup step(s)" << std::endl
+           << " Step time mean          " << mean << std::endl
+           << " Step time min           " << lo << std::endl
+           << " Step time p50           " << percentile(sorted, 50) << std::endl
+           << " Step time p90           " << percentile(sorted, 90) << std::endl
+           << " Step time p99           " << percentile(sorted, 99) << std::endl
+           << " Step time max           " << hi << std::endl
+           << " Step time jitter        " << stddev << " (" << std::fixed << std::setprecision(2)
+           << (mean > 0 ? 100.0 * stddev / mean : 0.0) << "%)" << std::scientific << std::setprecision(4) << std::endl
+           << " Rank jitter min         " << *quiet << " (rank " << quiet - rank_jitter.begin() << ")" << std::endl
+           << " Rank jitter max         " << *noisy << " (rank " << noisy - rank_jitter.begin() << ")" << std::endl
+           << " Steady time per cell    " << mean / cells << std::endl
+           << " Step time histogram" << std::endl;
+    for (int b = 0; b < bins; ++b) {
+      double from = lo + (hi - lo) * b / bins;
+      stream << "  " << from << " " << std::setw(6) << histogram[b] << " "
+             << std::string(tallest > 0 ? size_t(40 * histogram[b] / tallest) : 0, '#') << std::endl;
+    }
+    stream << std::defaultfloat << std::setprecision(6);
+  };
+  writeSteps(g_out);
+  if (clover::logging::to_console(clover::logging::level::summary)) writeSteps(std::cout);
+}
+
+} // namespace clover::steps
@@ -0,0 +1,38 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "comms.h"
+#include "definitions.h"
+
+#include <vector>
+
+//  @brief Steady-state step time statistics
+//  @details The per-step wall times of a run, minus the first warmup_steps steps
+//  (start up costs such as first touch, JIT compilation or MPI connection set up),
+//  summarised as mean, percentiles and jitter with a histogram. A step is as slow as
+//  its slowest rank, so the series reported is the per-step maximum over the ranks;
+//  the jitter of each rank on its own is reported as well to spot a noisy node.
+namespace clover::steps {
+
+// Reduces the step times over all ranks and prints the statistics on the boss, must be called on every rank
+void report(const global_variables &globals, const parallel_ &parallel, const std::vector<double> &times);
+
+} // namespace clover::steps
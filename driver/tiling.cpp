@@ -0,0 +1,169 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Tile layouts for the chunk of a task
+//  @details The working set is counted in padded arrays: every field has two
+//  halo cells on each side plus one more for the node centred ones, and
+//  the largest kernels (PdV, and the cell advection sweep) touch 14 of them.
+//  The budget is half the LLC share of a rank, but never less than the L2,
+//  leaving the other half for the halos, the rank's other tiles and the
+//  code. Among the layouts that fit, the one with the least halo, row and
+//  per tile overhead per cell wins, which favours few tiles with long rows.
+
+#include "tiling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace clover::tiling {
+
+namespace {
+
+constexpr int kernel_fields = 14;
+constexpr int padding = 5;      // Halo cells of a node centred field over both sides
+constexpr int min_cells = 16;   // Smallest tile extent auto will pick, below this the halos dominate
+constexpr int row_cost = 16;    // Loop start up overhead of a row, in cells
+constexpr int line_cells = 8;   // Doubles per 64 byte cache line
+constexpr int tile_cost = 4096; // Per tile overhead of a kernel (the parallel region, the tile halo copies), in cells
+constexpr std::size_t default_l2 = std::size_t(1) << 20;
+constexpr std::size_t default_llc = std::size_t(32) << 20;
+
+// Sizes in sysfs read like "48K" or "32M"
+std::size_t parse_size(const std::string &text) {
+  std::size_t end = 0;
+  std::size_t value = std::stoul(text, &end);
+  if (end < text.size()) {
+    switch (text[end]) {
+      case 'K': return value << 10;
+      case 'M': return value << 20;
+      case 'G': return value << 30;
+      default: break;
+    }
+  }
+  return value;
+}
+
+// Extent of an interior tile when align is in effect
+int aligned_extent(int cells, int tiles, int align) {
+  int extent = (cells + tiles - 1) / tiles;
+  if (align > 1) extent += (align - (extent + 4) % align) % align;
+  return extent;
+}
+
+} // namespace
+
+caches detect() {
+  caches sizes{0, 0};
+  int llc_level = 0;
+  for (int index = 0;; ++index) {
+    std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+    std::ifstream level_file(dir + "level"), type_file(dir + "type"), size_file(dir + "size");
+    if (!level_file || !type_file || !size_file) break;
+    int level;
+    std::string type, size;
+    if (!(level_file >> level) || !(type_file >> type) || !(size_file >> size) || type == "Instruction") continue;
+    try {
+      std::size_t bytes = parse_size(size);
+      if (level == 2) sizes.l2 = bytes;
+      if (level >= llc_level) {
+        llc_level = level;
+        sizes.llc = bytes;
+      }
+    } catch (const std::exception &) {
+      continue;
+    }
+  }
+  if (sizes.l2 == 0) sizes.l2 = default_l2;
+  if (llc_level < 2) sizes.llc = default_llc;
+  return sizes;
+}
+
+std::size_t working_set(int nx, int ny) {
+  return std::size_t(kernel_fields) * sizeof(double) * std::size_t(nx + padding) * std::size_t(ny + padding);
+}
+
+layout factorise(int tiles, int chunk_x_cells, int chunk_y_cells) {
+  double chunk_mesh_ratio = (double)chunk_x_cells / (double)chunk_y_cells;
+
+  int tile_x = tiles;
+  int tile_y = 1;
+
+  // The factorisation whose ratio is closest to the mesh ratio, measured on a log scale so a layout twice as wide
+  // as the chunk is as far off as one twice as narrow. Ties go to the layout with more tiles along x, as prime tile
+  // counts on a square chunk always did.
+  double best_distance = -1;
+  for (int t = 1; t <= tiles; ++t) {
+    if (tiles % t == 0) {
+      int factor_x = tiles / t;
+      int factor_y = t;
+      double distance = std::abs(std::log((double)factor_x / (double)factor_y / chunk_mesh_ratio));
+      if (best_distance < 0 || distance < best_distance - 1e-12) {
+        tile_x = factor_x;
+        tile_y = factor_y;
+        best_distance = distance;
+      }
+    }
+  }
+  return {tile_x, tile_y, 1};
+}
+
+layout choose(int chunk_x_cells, int chunk_y_cells, const caches &sizes, int ranks_sharing) {
+  std::size_t budget = std::max(sizes.l2, sizes.llc / 2 / std::size_t(std::max(ranks_sharing, 1)));
+  int max_x = std::max(chunk_x_cells / min_cells, 1);
+  int max_y = std::max(chunk_y_cells / min_cells, 1);
+
+  layout best{max_x, max_y, line_cells}; // If nothing fits, go as small as auto allows
+  double best_cost = -1;
+  for (int tile_y = 1; tile_y <= max_y; ++tile_y) {
+    for (int tile_x = 1; tile_x <= max_x; ++tile_x) {
+      int nx = aligned_extent(chunk_x_cells, tile_x, tile_x > 1 ? line_cells : 1);
+      int ny = aligned_extent(chunk_y_cells, tile_y, 1);
+      if (working_set(nx, ny) > budget) continue;
+      // Per cell, so a layout with more but better shaped tiles can win over one with fewer
+      double cost = (double(nx + padding + row_cost) * double(ny + padding) + tile_cost) / (double(nx) * double(ny));
+      if (best_cost < 0 || cost < best_cost) {
+        best = {tile_x, tile_y, line_cells};
+        best_cost = cost;
+      }
+    }
+  }
+  return best;
+}
+
+std::vector<int> split(int cells, int tiles, int align) {
+  std::vector<int> extents(tiles, cells / tiles);
+  if (align > 1 && tiles > 1) {
+    int extent = aligned_extent(cells, tiles, align);
+    int last = cells - extent * (tiles - 1);
+    // Only when the edge tile keeps at least half an interior tile, otherwise fall back to the even split
+    if (2 * last >= extent) {
+      std::fill(extents.begin(), extents.end() - 1, extent);
+      extents.back() = last;
+      return extents;
+    }
+  }
+  for (int t = 0; t < cells % tiles; ++t)
+    ++extents[t];
+  return extents;
+}
+
+} // namespace clover::tiling
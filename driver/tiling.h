@@ -0,0 +1,62 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//  @brief Tile layouts for the chunk of a task
+//  @details Each chunk is split into tiles_x by tiles_y tiles, which the kernels
+//  visit one after the other. With tiles_per_chunk set the layout is the
+//  factorisation closest to the chunk's aspect ratio. With tiles_per_chunk auto
+//  it is the cheapest layout for which the largest advection or PdV kernel's
+//  working set on one tile fits the cache budget, so the loops inside a kernel
+//  reuse what the previous loop brought in instead of streaming the chunk from
+//  memory again.
+namespace clover::tiling {
+
+// Data cache sizes in bytes
+struct caches {
+  std::size_t l2, llc;
+};
+
+struct layout {
+  int tiles_x, tiles_y;
+  // Interior tiles are sized so their rows, halo included, are a multiple of this many cells and the tile at the
+  // chunk's top or right edge takes what is left over. 1 spreads the cells evenly over the tiles instead.
+  int align;
+};
+
+// The caches of cpu0 as listed in sysfs, with defaults for whatever cannot be read
+caches detect();
+
+// Bytes touched by the largest advection or PdV kernel on a tile of nx by ny cells
+std::size_t working_set(int nx, int ny);
+
+// The layout for a fixed tile count
+layout factorise(int tiles, int chunk_x_cells, int chunk_y_cells);
+
+// The layout for tiles_per_chunk auto, given the caches and the number of ranks sharing the LLC
+layout choose(int chunk_x_cells, int chunk_y_cells, const caches &sizes, int ranks_sharing);
+
+// Cells of each tile along one axis of a chunk
+std::vector<int> split(int cells, int tiles, int align);
+
+} // namespace clover::tiling
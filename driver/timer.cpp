@@ -23,13 +23,14 @@
  *  @details C function to call from fortran.
  */
 
-#include <cstdlib>
-#include <sys/resource.h>
-#include <sys/time.h>
-#include <sys/times.h>
-
-double timer() {
-  timeval t{};
-  gettimeofday(&t, (struct timezone *)nullptr);
-  return static_cast<double>(t.tv_sec) + static_cast<double>(t.tv_usec) * 1.0e-6;
+#include <cstdint>
+#include <ctime>
+
+// Monotonic, so intervals are immune to NTP steps; the epoch is arbitrary
+uint64_t timer_ns() {
+  timespec t{};
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return static_cast<uint64_t>(t.tv_sec) * 1000000000ull + static_cast<uint64_t>(t.tv_nsec);
 }
+
+double timer() { return static_cast<double>(timer_ns()) * 1.0e-9; }
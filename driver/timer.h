@@ -19,4 +19,7 @@
 
 #pragma once
 
+#include <cstdint>
+
 double timer();
+uint64_t timer_ns();
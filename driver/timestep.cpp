@@ -26,13 +26,14 @@
 #include "timestep.h"
 
 #include "calc_dt.h"
-#include "ideal_gas.h"
+#include "dirty.h"
+#include "logging.h"
+#include "perf_counters.h"
 #include "report.h"
 #include "timer.h"
-#include "update_halo.h"
-#include "viscosity.h"
+#include "trace.h"
 
-extern std::ostream g_out;
+extern thread_local std::ostream g_out;
 
 void timestep(global_variables &globals, parallel_ &parallel) {
 
@@ -43,11 +44,13 @@ void timestep(global_variables &globals, parallel_ &parallel) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::ideal_gas);
 
-  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
-  }
+  clover::trace::begin("ideal_gas");
+  clover::dirty::ideal_gas(globals);
+  clover::trace::end();
 
+  clover::counters::end(clover::counters::ideal_gas);
   if (globals.profiler_on) globals.profiler.ideal_gas += timer() - kernel_time;
 
   for (int i = 0; i < NUM_FIELDS; ++i)
@@ -57,16 +60,20 @@ void timestep(global_variables &globals, parallel_ &parallel) {
   fields[field_density0] = 1;
   fields[field_xvel0] = 1;
   fields[field_yvel0] = 1;
-  update_halo(globals, fields, 1);
+  clover::dirty::update_halo(globals, fields, 1);
 
   if (globals.profiler_on) kernel_time = timer();
-  viscosity(globals);
+  clover::counters::begin(clover::counters::viscosity);
+  clover::trace::begin("viscosity");
+  clover::dirty::viscosity(globals);
+  clover::trace::end();
+  clover::counters::end(clover::counters::viscosity);
   if (globals.profiler_on) globals.profiler.viscosity += timer() - kernel_time;
 
   for (int i = 0; i < NUM_FIELDS; ++i)
     fields[i] = 0;
   fields[field_viscosity] = 1;
-  update_halo(globals, fields, 1);
+  clover::dirty::update_halo(globals, fields, 1);
 
   if (globals.profiler_on) kernel_time = timer();
 
@@ -74,6 +81,7 @@ void timestep(global_variables &globals, parallel_ &parallel) {
   double dtlp{};
   double x_pos{}, y_pos{}, xl_pos{}, yl_pos{};
   std::string dt_control, dtl_control;
+  clover::trace::begin("calc_dt");
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
     calc_dt(globals, tile, dtlp, dtl_control, xl_pos, yl_pos, jldt, kldt);
 
@@ -89,17 +97,20 @@ void timestep(global_variables &globals, parallel_ &parallel) {
 
   globals.dt = std::min(std::min(globals.dt, globals.dtold * globals.config.dtrise), globals.config.dtmax);
 
+  clover::trace::end();
+
   //	globals.queue.wait_and_throw();
   clover_min(globals.dt);
   if (globals.profiler_on) globals.profiler.timestep += timer() - kernel_time;
 
   if (globals.dt < globals.config.dtmin) small = 1;
 
-  if (parallel.boss) {
+  if (parallel.boss && clover::logging::step_line(globals.step)) {
     g_out << " Step " << globals.step << " time " << globals.time << " control " << dt_control << " timestep  " << globals.dt << " "
           << globals.jdt << "," << globals.kdt << " x " << x_pos << " y " << y_pos << std::endl;
-    std::cout << " Step " << globals.step << " time " << globals.time << " control " << dt_control << " timestep  " << globals.dt << " "
-              << globals.jdt << "," << globals.kdt << " x " << x_pos << " y " << y_pos << std::endl;
+    if (clover::logging::to_console(clover::logging::level::step))
+      std::cout << " Step " << globals.step << " time " << globals.time << " control " << dt_control << " timestep  " << globals.dt
+                << " " << globals.jdt << "," << globals.kdt << " x " << x_pos << " y " << y_pos << std::endl;
   }
   if (small == 1) {
     report_error((char *)"timestep", (char *)"small timestep");
@@ -0,0 +1,219 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+//  @brief Timeline tracing
+//  @details Each thread owns a fixed size ring buffer, registered once on first
+//  use, so recording an event is a clock read and two stores. When a buffer
+//  wraps the oldest events are overwritten and the number lost is reported in
+//  the trace metadata. MPI calls are traced through the standard PMPI profiling
+//  interface, so no call site in the models needs to know about tracing.
+
+#include "trace.h"
+#include "timer.h"
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef NO_MPI
+  #define OMPI_SKIP_MPICXX
+  #include <mpi.h>
+#endif
+
+namespace clover::trace {
+
+bool enabled = false;
+
+namespace {
+
+struct event {
+  const char *name; // nullptr marks an end event
+  uint64_t ns;
+};
+
+// 2^16 events (1 MiB) per thread is several hundred steps of full detail
+constexpr size_t capacity = size_t(1) << 16;
+
+struct ring {
+  int tid;
+  uint64_t head = 0; // total events ever written, the slot is head % capacity
+  std::vector<event> events;
+  explicit ring(int tid) : tid(tid), events(capacity) {}
+};
+
+std::mutex registry_lock;
+std::vector<std::unique_ptr<ring>> registry;
+std::string trace_prefix;
+int trace_rank = 0;
+uint64_t epoch_ns = 0;
+
+ring &local_ring() {
+  thread_local ring *local = nullptr;
+  if (!local) {
+    std::lock_guard<std::mutex> guard(registry_lock);
+    registry.push_back(std::make_unique<ring>(static_cast<int>(registry.size())));
+    local = registry.back().get();
+  }
+  return *local;
+}
+
+inline void push(const char *name) {
+  ring &r = local_ring();
+  r.events[r.head % capacity] = {name, timer_ns()};
+  r.head++;
+}
+
+} // namespace
+
+void record_begin(const char *name) { push(name); }
+
+void record_end() { push(nullptr); }
+
+void start(const std::string &prefix, int rank) {
+  trace_prefix = prefix;
+  trace_rank = rank;
+  epoch_ns = timer_ns();
+  enabled = true;
+}
+
+void finish() {
+  if (!enabled) return;
+  enabled = false;
+
+  const std::string file = trace_prefix + "_" + std::to_string(trace_rank) + ".json";
+  std::ofstream out(file);
+  if (!out) {
+    std::cerr << "Unable to write trace file: `" << file << "`" << std::endl;
+    return;
+  }
+
+  // ts is in microseconds, printed with ns resolution
+  auto timestamp = [](uint64_t ns) {
+    uint64_t rel = ns > epoch_ns ? ns - epoch_ns : 0;
+    return std::to_string(rel / 1000) + "." + std::to_string(1000 + rel % 1000).substr(1);
+  };
+
+  std::lock_guard<std::mutex> guard(registry_lock);
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+  out << R"({"name":"process_name","ph":"M","pid":)" << trace_rank << R"(,"args":{"name":"rank )" << trace_rank << "\"}}";
+  for (const auto &r : registry) {
+    const uint64_t first = r->head > capacity ? r->head - capacity : 0;
+    out << ",\n"
+        << R"({"name":"thread_name","ph":"M","pid":)" << trace_rank << ",\"tid\":" << r->tid << R"(,"args":{"name":"thread )" << r->tid
+        << "\",\"dropped_events\":" << first << "}}";
+    // After a wrap the oldest surviving events may be ends whose begins were overwritten, skip those
+    int depth = 0;
+    for (uint64_t i = first; i < r->head; ++i) {
+      const event &e = r->events[i % capacity];
+      if (!e.name && depth == 0) continue;
+      depth += e.name ? 1 : -1;
+      out << ",\n{";
+      if (e.name) out << "\"name\":\"" << e.name << "\",\"ph\":\"B\"";
+      else out << "\"ph\":\"E\"";
+      out << ",\"pid\":" << trace_rank << ",\"tid\":" << r->tid << ",\"ts\":" << timestamp(e.ns) << "}";
+    }
+  }
+  out << "\n]}\n";
+}
+
+} // namespace clover::trace
+
+#ifndef NO_MPI
+
+// PMPI interposition: the MPI standard guarantees every MPI_X is also callable as PMPI_X,
+// so defining MPI_X here wraps all calls made by the driver and the models
+using clover::trace::begin;
+using clover::trace::end;
+
+int MPI_Barrier(MPI_Comm comm) {
+  begin("MPI_Barrier");
+  int result = PMPI_Barrier(comm);
+  end();
+  return result;
+}
+
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm) {
+  begin("MPI_Bcast");
+  int result = PMPI_Bcast(buffer, count, datatype, root, comm);
+  end();
+  return result;
+}
+
+int MPI_Reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm) {
+  begin("MPI_Reduce");
+  int result = PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+  end();
+  return result;
+}
+
+int MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
+  begin("MPI_Allreduce");
+  int result = PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+  end();
+  return result;
+}
+
+int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype,
+                  MPI_Comm comm) {
+  begin("MPI_Allgather");
+  int result = PMPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+  end();
+  return result;
+}
+
+int MPI_Isend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request) {
+  begin("MPI_Isend");
+  int result = PMPI_Isend(buf, count, datatype, dest, tag, comm, request);
+  end();
+  return result;
+}
+
+int MPI_Irecv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request *request) {
+  begin("MPI_Irecv");
+  int result = PMPI_Irecv(buf, count, datatype, source, tag, comm, request);
+  end();
+  return result;
+}
+
+int MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status *array_of_statuses) {
+  begin("MPI_Waitall");
+  int result = PMPI_Waitall(count, array_of_requests, array_of_statuses);
+  end();
+  return result;
+}
+
+int MPI_Neighbor_alltoallw(const void *sendbuf, const int sendcounts[], const MPI_Aint sdispls[], const MPI_Datatype sendtypes[],
+                           void *recvbuf, const int recvcounts[], const MPI_Aint rdispls[], const MPI_Datatype recvtypes[],
+                           MPI_Comm comm) {
+  begin("MPI_Neighbor_alltoallw");
+  int result = PMPI_Neighbor_alltoallw(sendbuf, sendcounts, sdispls, sendtypes, recvbuf, recvcounts, rdispls, recvtypes, comm);
+  end();
+  return result;
+}
+
+int MPI_Win_sync(MPI_Win win) {
+  begin("MPI_Win_sync");
+  int result = PMPI_Win_sync(win);
+  end();
+  return result;
+}
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <string>
+
+//  @brief Timeline tracing
+//  @details Records begin/end events into per-thread ring buffers and writes
+//  them out as a Chrome/Perfetto trace (chrome://tracing or ui.perfetto.dev)
+//  at the end of the run. Recording is lock-free, each thread only ever
+//  touches its own buffer. When tracing is off every call site costs a single
+//  predictable branch on clover::trace::enabled.
+namespace clover::trace {
+
+extern bool enabled;
+
+// Out of line slow paths, only reached when tracing is on
+void record_begin(const char *name);
+void record_end();
+
+// Names must be string literals (or otherwise outlive the run), only the pointer is stored
+inline void begin(const char *name) {
+  if (enabled) record_begin(name);
+}
+inline void end() {
+  if (enabled) record_end();
+}
+
+// Enables tracing for this rank, events are written to <prefix>_<rank>.json by finish()
+void start(const std::string &prefix, int rank);
+
+// Writes the trace for this rank if tracing was started; must be called once all traced threads are idle
+void finish();
+
+} // namespace clover::trace
@@ -18,10 +18,8 @@
  */
 
 #include "visit.h"
-#include "ideal_gas.h"
+#include "dirty.h"
 #include "timer.h"
-#include "update_halo.h"
-#include "viscosity.h"
 
 #include <cmath>
 #include <fstream>
@@ -33,7 +31,8 @@
 //  @details The field data over all mesh chunks is written to a .vtk files and
 //  the .visit file is written that defines the time for each set of vtk files.
 //  The ideal gas and viscosity routines are invoked to make sure this data is
-//  up to data with the current energy, density and velocity.
+//  up to data with the current energy, density and velocity, which they
+//  usually already are after a field summary (see dirty.h).
 
 static bool first_call = true;
 
@@ -56,9 +55,7 @@ void visit(global_variables &globals, parallel_ &parallel) {
 
   double kernel_time{};
   if (globals.profiler_on) kernel_time = timer();
-  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
-  }
+  clover::dirty::ideal_gas(globals);
   if (globals.profiler_on) globals.profiler.ideal_gas += timer() - kernel_time;
 
   int fields[NUM_FIELDS];
@@ -67,10 +64,10 @@ void visit(global_variables &globals, parallel_ &parallel) {
   fields[field_pressure] = 1;
   fields[field_xvel0] = 1;
   fields[field_yvel0] = 1;
-  update_halo(globals, fields, 1);
+  clover::dirty::update_halo(globals, fields, 1);
 
   if (globals.profiler_on) kernel_time = timer();
-  viscosity(globals);
+  clover::dirty::viscosity(globals);
   if (globals.profiler_on) globals.profiler.viscosity += timer() - kernel_time;
 
   if (parallel.boss) {
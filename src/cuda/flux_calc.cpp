@@ -19,6 +19,7 @@
 
 #include "flux_calc.h"
 #include "context.h"
+#include "perf_counters.h"
 #include "timer.h"
 
 //  @brief Fortran flux kernel.
@@ -46,6 +47,7 @@ void flux_calc(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::flux_calc);
 
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
 
@@ -54,6 +56,7 @@ void flux_calc(global_variables &globals) {
                      t.field.yvel0, t.field.xvel1, t.field.yvel1, t.field.vol_flux_x, t.field.vol_flux_y);
   }
 
+  clover::counters::end(clover::counters::flux_calc);
   if (globals.profiler_on) {
     clover::checkError(cudaDeviceSynchronize());
     globals.profiler.flux += timer() - kernel_time;
@@ -21,6 +21,7 @@
 #include "comms.h"
 #include "context.h"
 #include "ideal_gas.h"
+#include "perf_counters.h"
 #include "report.h"
 #include "revert.h"
 #include "timer.h"
@@ -87,6 +88,7 @@ void PdV(global_variables &globals, bool predict) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::PdV);
 
   globals.error_condition = 0;
 
@@ -98,6 +100,7 @@ void PdV(global_variables &globals, bool predict) {
   }
 
   clover_check_error(globals.error_condition);
+  clover::counters::end(clover::counters::PdV);
   if (globals.profiler_on) {
     clover::checkError(hipDeviceSynchronize());
     globals.profiler.PdV += timer() - kernel_time;
@@ -109,10 +112,12 @@ void PdV(global_variables &globals, bool predict) {
 
   if (predict) {
     if (globals.profiler_on) kernel_time = timer();
+    clover::counters::begin(clover::counters::ideal_gas);
     for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
       ideal_gas(globals, tile, true);
     }
 
+    clover::counters::end(clover::counters::ideal_gas);
     if (globals.profiler_on) {
       clover::checkError(hipDeviceSynchronize());
       globals.profiler.ideal_gas += timer() - kernel_time;
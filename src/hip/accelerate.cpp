@@ -19,6 +19,7 @@
 
 #include "accelerate.h"
 #include "context.h"
+#include "perf_counters.h"
 #include "timer.h"
 
 //#define par_ranged2m(rg, f) \
@@ -69,6 +70,7 @@ void accelerate(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::accelerate);
 
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
     tile_type &t = globals.chunk.tiles[tile];
@@ -77,6 +79,7 @@ void accelerate(global_variables &globals) {
                       t.field.density0, t.field.pressure, t.field.viscosity, t.field.xvel0, t.field.yvel0, t.field.xvel1, t.field.yvel1);
   }
 
+  clover::counters::end(clover::counters::accelerate);
   if (globals.profiler_on) {
     clover::checkError(hipDeviceSynchronize());
     globals.profiler.acceleration += timer() - kernel_time;
@@ -30,43 +30,8 @@
 
 void generate_chunk(const int tile, global_variables &globals) {
 
-  // Need to copy the host array of state input data into a device array
-  std::vector<double> state_density_vec(globals.config.number_of_states);
-  std::vector<double> state_energy_vec(globals.config.number_of_states);
-  std::vector<double> state_xvel_vec(globals.config.number_of_states);
-  std::vector<double> state_yvel_vec(globals.config.number_of_states);
-  std::vector<double> state_xmin_vec(globals.config.number_of_states);
-  std::vector<double> state_xmax_vec(globals.config.number_of_states);
-  std::vector<double> state_ymin_vec(globals.config.number_of_states);
-  std::vector<double> state_ymax_vec(globals.config.number_of_states);
-  std::vector<double> state_radius_vec(globals.config.number_of_states);
-  std::vector<int> state_geometry_vec(globals.config.number_of_states);
-
-  // Copy the data to the new views
-  for (int state = 0; state < globals.config.number_of_states; ++state) {
-    state_density_vec[state] = globals.config.states[state].density;
-    state_energy_vec[state] = globals.config.states[state].energy;
-    state_xvel_vec[state] = globals.config.states[state].xvel;
-    state_yvel_vec[state] = globals.config.states[state].yvel;
-    state_xmin_vec[state] = globals.config.states[state].xmin;
-    state_xmax_vec[state] = globals.config.states[state].xmax;
-    state_ymin_vec[state] = globals.config.states[state].ymin;
-    state_ymax_vec[state] = globals.config.states[state].ymax;
-    state_radius_vec[state] = globals.config.states[state].radius;
-    state_geometry_vec[state] = globals.config.states[state].geometry;
-  }
-
-  // Need to copy the host array of state input data into a device array
-  clover::Buffer1D<double> state_density(globals.context, globals.config.number_of_states, state_density_vec.data());
-  clover::Buffer1D<double> state_energy(globals.context, globals.config.number_of_states, state_energy_vec.data());
-  clover::Buffer1D<double> state_xvel(globals.context, globals.config.number_of_states, state_xvel_vec.data());
-  clover::Buffer1D<double> state_yvel(globals.context, globals.config.number_of_states, state_yvel_vec.data());
-  clover::Buffer1D<double> state_xmin(globals.context, globals.config.number_of_states, state_xmin_vec.data());
-  clover::Buffer1D<double> state_xmax(globals.context, globals.config.number_of_states, state_xmax_vec.data());
-  clover::Buffer1D<double> state_ymin(globals.context, globals.config.number_of_states, state_ymin_vec.data());
-  clover::Buffer1D<double> state_ymax(globals.context, globals.config.number_of_states, state_ymax_vec.data());
-  clover::Buffer1D<double> state_radius(globals.context, globals.config.number_of_states, state_radius_vec.data());
-  clover::Buffer1D<int> state_geometry(globals.context, globals.config.number_of_states, state_geometry_vec.data());
+  // States are captured by value into the kernels, so no device state table is needed
+  const std::vector<state_type> &states = globals.config.states;
 
   const int x_min = globals.chunk.tiles[tile].info.t_xmin;
   const int x_max = globals.chunk.tiles[tile].info.t_xmax;
@@ -84,71 +49,66 @@ void generate_chunk(const int tile, global_variables &globals) {
 
   // State 1 is always the background state
 
+  const state_type background = states[0];
   clover::par_ranged2(xyrange_policy, [=] DEVICE_KERNEL(const size_t i, const size_t j) {
-    field.energy0(i, j) = state_energy[0];
-    field.density0(i, j) = state_density[0];
-    field.xvel0(i, j) = state_xvel[0];
-    field.yvel0(i, j) = state_yvel[0];
+    field.energy0(i, j) = background.energy;
+    field.density0(i, j) = background.density;
+    field.xvel0(i, j) = background.xvel;
+    field.yvel0(i, j) = background.yvel;
   });
 
   for (int state = 1; state < globals.config.number_of_states; ++state) {
+    // Only sweep the cells this state can cover
+    const state_extent extent = generate_state_extent(globals, tile, states[state]);
+    if (extent.empty) continue;
 
-    clover::par_ranged2(xyrange_policy, [=] DEVICE_KERNEL(const size_t x, const size_t y) {
+    const state_type s = states[state];
+    clover::Range2d extent_policy(extent.fromX, extent.fromY, extent.toX, extent.toY);
+    clover::par_ranged2(extent_policy, [=] DEVICE_KERNEL(const size_t x, const size_t y) {
       const int j = x;
       const int k = y;
 
-      double x_cent = state_xmin[state];
-      double y_cent = state_ymin[state];
+      double x_cent = s.xmin;
+      double y_cent = s.ymin;
 
-      if (state_geometry[state] == g_rect) {
-        if (field.vertexx[j + 1] >= state_xmin[state] && field.vertexx[j] < state_xmax[state]) {
-          if (field.vertexy[k + 1] >= state_ymin[state] && field.vertexy[k] < state_ymax[state]) {
-            field.energy0(x, y) = state_energy[state];
-            field.density0(x, y) = state_density[state];
+      if (s.geometry == g_rect) {
+        if (field.vertexx[j + 1] >= s.xmin && field.vertexx[j] < s.xmax) {
+          if (field.vertexy[k + 1] >= s.ymin && field.vertexy[k] < s.ymax) {
+            field.energy0(x, y) = s.energy;
+            field.density0(x, y) = s.density;
             for (int kt = k; kt <= k + 1; ++kt) {
               for (int jt = j; jt <= j + 1; ++jt) {
-                field.xvel0(jt, kt) = state_xvel[state];
-                field.yvel0(jt, kt) = state_yvel[state];
+                field.xvel0(jt, kt) = s.xvel;
+                field.yvel0(jt, kt) = s.yvel;
               }
             }
           }
         }
-      } else if (state_geometry[state] == g_circ) {
+      } else if (s.geometry == g_circ) {
         double radius =
             std::sqrt((field.cellx[j] - x_cent) * (field.cellx[j] - x_cent) + (field.celly[k] - y_cent) * (field.celly[k] - y_cent));
-        if (radius <= state_radius[state]) {
-          field.energy0(x, y) = state_energy[state];
-          field.density0(x, y) = state_density[state];
+        if (radius <= s.radius) {
+          field.energy0(x, y) = s.energy;
+          field.density0(x, y) = s.density;
           for (int kt = k; kt <= k + 1; ++kt) {
             for (int jt = j; jt <= j + 1; ++jt) {
-              field.xvel0(jt, kt) = state_xvel[state];
-              field.yvel0(jt, kt) = state_yvel[state];
+              field.xvel0(jt, kt) = s.xvel;
+              field.yvel0(jt, kt) = s.yvel;
             }
           }
         }
-      } else if (state_geometry[state] == g_point) {
+      } else if (s.geometry == g_point) {
         if (field.vertexx[j] == x_cent && field.vertexy[k] == y_cent) {
-          field.energy0(x, y) = state_energy[state];
-          field.density0(x, y) = state_density[state];
+          field.energy0(x, y) = s.energy;
+          field.density0(x, y) = s.density;
           for (int kt = k; kt <= k + 1; ++kt) {
             for (int jt = j; jt <= j + 1; ++jt) {
-              field.xvel0(jt, kt) = state_xvel[state];
-              field.yvel0(jt, kt) = state_yvel[state];
+              field.xvel0(jt, kt) = s.xvel;
+              field.yvel0(jt, kt) = s.yvel;
             }
           }
         }
       }
     });
   }
-
-  state_density.release();
-  state_energy.release();
-  state_xvel.release();
-  state_yvel.release();
-  state_xmin.release();
-  state_xmax.release();
-  state_ymin.release();
-  state_ymax.release();
-  state_radius.release();
-  state_geometry.release();
 }
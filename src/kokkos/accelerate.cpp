@@ -18,6 +18,7 @@
  */
 
 #include "accelerate.h"
+#include "perf_counters.h"
 #include "timer.h"
 
 // @brief Fortran acceleration kernel
@@ -58,6 +59,7 @@ void accelerate(global_variables &globals) {
 
   double kernel_time{};
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::accelerate);
 
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
 
@@ -70,5 +72,6 @@ void accelerate(global_variables &globals) {
                       globals.chunk.tiles[tile].field.yvel1.view);
   }
 
+  clover::counters::end(clover::counters::accelerate);
   if (globals.profiler_on) globals.profiler.acceleration += timer() - kernel_time;
 }
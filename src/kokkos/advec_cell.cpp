@@ -19,6 +19,8 @@
 
 #include "advec_cell.h"
 
+bool advec_simd_supported() { return false; }
+
 //  @brief Fortran cell advection kernel.
 //  @author Wayne Gaudin
 //  @details Performs a second order advective remap using van-Leer limiting
@@ -66,7 +68,7 @@ void advec_cell_kernel(int x_min, int x_max, int y_min, int y_max, int dir, int
             downwind = j;
             dif = donor;
           } else {
-            upwind = Kokkos::min(j + 1, x_max + 2);
+            upwind = Kokkos::min(j + 1, x_max + 3);
             donor = j;
             downwind = j - 1;
             dif = upwind;
@@ -153,7 +155,7 @@ void advec_cell_kernel(int x_min, int x_max, int y_min, int y_max, int dir, int
             downwind = k;
             dif = donor;
           } else {
-            upwind = Kokkos::min(k + 1, y_max + 2);
+            upwind = Kokkos::min(k + 1, y_max + 3);
             donor = k;
             downwind = k - 1;
             dif = upwind;
@@ -0,0 +1,40 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "field_view.h"
+
+// The view's layout and memory space are whatever Kokkos picked for the default execution space
+clover::field_view clover_field_view(global_variables &globals, int tile, int field) {
+  auto *buffer = clover::field_buffer(globals.chunk.tiles[tile].field, field);
+  if (!buffer) return {nullptr, 0, 0, 0, 0, clover::field_view::memory::none};
+  const auto &view = buffer->view;
+  constexpr bool host = Kokkos::SpaceAccessibility<Kokkos::HostSpace, Kokkos::View<double **>::memory_space>::accessible;
+  return {view.data(),
+          view.extent(0),
+          view.extent(1),
+          static_cast<std::ptrdiff_t>(view.stride(0)),
+          static_cast<std::ptrdiff_t>(view.stride(1)),
+          host ? clover::field_view::memory::host : clover::field_view::memory::device};
+}
+
+// The view may live in device memory, so it is copied through a host mirror, which keeps its layout
+std::vector<double> clover_field_host(global_variables &, clover::Buffer2D<double> &buffer) {
+  auto mirror = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), buffer.view);
+  return {mirror.data(), mirror.data() + mirror.size()};
+}
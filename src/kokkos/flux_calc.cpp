@@ -18,6 +18,7 @@
  */
 
 #include "flux_calc.h"
+#include "perf_counters.h"
 #include "timer.h"
 
 //  @brief Fortran flux kernel.
@@ -47,6 +48,7 @@ void flux_calc(global_variables &globals) {
 
   double kernel_time{};
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::flux_calc);
 
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
 
@@ -58,5 +60,6 @@ void flux_calc(global_variables &globals) {
                      globals.chunk.tiles[tile].field.vol_flux_y.view);
   }
 
+  clover::counters::end(clover::counters::flux_calc);
   if (globals.profiler_on) globals.profiler.flux += timer() - kernel_time;
 }
@@ -28,55 +28,8 @@
 
 void generate_chunk(const int tile, global_variables &globals) {
 
-  // Need to copy the host array of state input data into a device array
-  // XXX This probably doesn't need ViewAllocateWithoutInitializing because of how small `globals.number_of_states` is.
-  Kokkos::View<double *> state_density("state_density", globals.config.number_of_states);
-  Kokkos::View<double *> state_energy("state_energy", globals.config.number_of_states);
-  Kokkos::View<double *> state_xvel("state_xvel", globals.config.number_of_states);
-  Kokkos::View<double *> state_yvel("state_yvel", globals.config.number_of_states);
-  Kokkos::View<double *> state_xmin("state_xmin", globals.config.number_of_states);
-  Kokkos::View<double *> state_xmax("state_xmax", globals.config.number_of_states);
-  Kokkos::View<double *> state_ymin("state_ymin", globals.config.number_of_states);
-  Kokkos::View<double *> state_ymax("state_ymax", globals.config.number_of_states);
-  Kokkos::View<double *> state_radius("state_radius", globals.config.number_of_states);
-  Kokkos::View<int *> state_geometry("state_geometry", globals.config.number_of_states);
-
-  // Create host mirrors of this to copy on the host
-  typename Kokkos::View<double *>::HostMirror hm_state_density = Kokkos::create_mirror_view(state_density);
-  typename Kokkos::View<double *>::HostMirror hm_state_energy = Kokkos::create_mirror_view(state_energy);
-  typename Kokkos::View<double *>::HostMirror hm_state_xvel = Kokkos::create_mirror_view(state_xvel);
-  typename Kokkos::View<double *>::HostMirror hm_state_yvel = Kokkos::create_mirror_view(state_yvel);
-  typename Kokkos::View<double *>::HostMirror hm_state_xmin = Kokkos::create_mirror_view(state_xmin);
-  typename Kokkos::View<double *>::HostMirror hm_state_xmax = Kokkos::create_mirror_view(state_xmax);
-  typename Kokkos::View<double *>::HostMirror hm_state_ymin = Kokkos::create_mirror_view(state_ymin);
-  typename Kokkos::View<double *>::HostMirror hm_state_ymax = Kokkos::create_mirror_view(state_ymax);
-  typename Kokkos::View<double *>::HostMirror hm_state_radius = Kokkos::create_mirror_view(state_radius);
-  typename Kokkos::View<int *>::HostMirror hm_state_geometry = Kokkos::create_mirror_view(state_geometry);
-
-  // Copy the data to the new views
-  for (int state = 0; state < globals.config.number_of_states; ++state) {
-    hm_state_density(state) = globals.config.states[state].density;
-    hm_state_energy(state) = globals.config.states[state].energy;
-    hm_state_xvel(state) = globals.config.states[state].xvel;
-    hm_state_yvel(state) = globals.config.states[state].yvel;
-    hm_state_xmin(state) = globals.config.states[state].xmin;
-    hm_state_xmax(state) = globals.config.states[state].xmax;
-    hm_state_ymin(state) = globals.config.states[state].ymin;
-    hm_state_ymax(state) = globals.config.states[state].ymax;
-    hm_state_radius(state) = globals.config.states[state].radius;
-    hm_state_geometry(state) = globals.config.states[state].geometry;
-  }
-
-  Kokkos::deep_copy(state_density, hm_state_density);
-  Kokkos::deep_copy(state_energy, hm_state_energy);
-  Kokkos::deep_copy(state_xvel, hm_state_xvel);
-  Kokkos::deep_copy(state_yvel, hm_state_yvel);
-  Kokkos::deep_copy(state_xmin, hm_state_xmin);
-  Kokkos::deep_copy(state_xmax, hm_state_xmax);
-  Kokkos::deep_copy(state_ymin, hm_state_ymin);
-  Kokkos::deep_copy(state_ymax, hm_state_ymax);
-  Kokkos::deep_copy(state_radius, hm_state_radius);
-  Kokkos::deep_copy(state_geometry, hm_state_geometry);
+  // States are captured by value into the kernels, so no device state table is needed
+  const std::vector<state_type> &states = globals.config.states;
 
   const int x_min = globals.chunk.tiles[tile].info.t_xmin;
   const int x_max = globals.chunk.tiles[tile].info.t_xmax;
@@ -92,54 +45,61 @@ void generate_chunk(const int tile, global_variables &globals) {
   Kokkos::MDRangePolicy<Kokkos::Rank<2>> xyrange_policy({0, 0}, {xrange, yrange});
 
   // State 1 is always the background state
+  const state_type background = states[0];
   Kokkos::parallel_for(
       xyrange_policy, KOKKOS_LAMBDA(const int j, const int k) {
-        field.energy0.view(j, k) = state_energy(0);
-        field.density0.view(j, k) = state_density(0);
-        field.xvel0.view(j, k) = state_xvel(0);
-        field.yvel0.view(j, k) = state_yvel(0);
+        field.energy0.view(j, k) = background.energy;
+        field.density0.view(j, k) = background.density;
+        field.xvel0.view(j, k) = background.xvel;
+        field.yvel0.view(j, k) = background.yvel;
       });
 
   for (int state = 1; state < globals.config.number_of_states; ++state) {
+    // Only sweep the cells this state can cover
+    const state_extent extent = generate_state_extent(globals, tile, states[state]);
+    if (extent.empty) continue;
+
+    const state_type s = states[state];
+    Kokkos::MDRangePolicy<Kokkos::Rank<2>> extent_policy({extent.fromX, extent.fromY}, {extent.toX, extent.toY});
     Kokkos::parallel_for(
-        xyrange_policy, KOKKOS_LAMBDA(const int j, const int k) {
-          double x_cent = state_xmin(state);
-          double y_cent = state_ymin(state);
-
-          if (state_geometry(state) == g_rect) {
-            if (field.vertexx.view(j + 1) >= state_xmin(state) && field.vertexx.view(j) < state_xmax(state)) {
-              if (field.vertexy.view(k + 1) >= state_ymin(state) && field.vertexy.view(k) < state_ymax(state)) {
-                field.energy0.view(j, k) = state_energy(state);
-                field.density0.view(j, k) = state_density(state);
+        extent_policy, KOKKOS_LAMBDA(const int j, const int k) {
+          double x_cent = s.xmin;
+          double y_cent = s.ymin;
+
+          if (s.geometry == g_rect) {
+            if (field.vertexx.view(j + 1) >= s.xmin && field.vertexx.view(j) < s.xmax) {
+              if (field.vertexy.view(k + 1) >= s.ymin && field.vertexy.view(k) < s.ymax) {
+                field.energy0.view(j, k) = s.energy;
+                field.density0.view(j, k) = s.density;
                 for (int kt = k; kt <= k + 1; ++kt) {
                   for (int jt = j; jt <= j + 1; ++jt) {
-                    field.xvel0.view(jt, kt) = state_xvel(state);
-                    field.yvel0.view(jt, kt) = state_yvel(state);
+                    field.xvel0.view(jt, kt) = s.xvel;
+                    field.yvel0.view(jt, kt) = s.yvel;
                   }
                 }
               }
             }
-          } else if (state_geometry(state) == g_circ) {
+          } else if (s.geometry == g_circ) {
             double radius = sqrt((field.cellx.view(j) - x_cent) * (field.cellx.view(j) - x_cent) +
                                  (field.celly.view(k) - y_cent) * (field.celly.view(k) - y_cent));
-            if (radius <= state_radius(state)) {
-              field.energy0.view(j, k) = state_energy(state);
-              field.density0.view(j, k) = state_density(state);
+            if (radius <= s.radius) {
+              field.energy0.view(j, k) = s.energy;
+              field.density0.view(j, k) = s.density;
               for (int kt = k; kt <= k + 1; ++kt) {
                 for (int jt = j; jt <= j + 1; ++jt) {
-                  field.xvel0.view(jt, kt) = state_xvel(state);
-                  field.yvel0.view(jt, kt) = state_yvel(state);
+                  field.xvel0.view(jt, kt) = s.xvel;
+                  field.yvel0.view(jt, kt) = s.yvel;
                 }
               }
             }
-          } else if (state_geometry(state) == g_point) {
+          } else if (s.geometry == g_point) {
             if (field.vertexx.view(j) == x_cent && field.vertexy.view(k) == y_cent) {
-              field.energy0.view(j, k) = state_energy(state);
-              field.density0.view(j, k) = state_density(state);
+              field.energy0.view(j, k) = s.energy;
+              field.density0.view(j, k) = s.density;
               for (int kt = k; kt <= k + 1; ++kt) {
                 for (int jt = j; jt <= j + 1; ++jt) {
-                  field.xvel0.view(jt, kt) = state_xvel(state);
-                  field.yvel0.view(jt, kt) = state_yvel(state);
+                  field.xvel0.view(jt, kt) = s.xvel;
+                  field.yvel0.view(jt, kt) = s.yvel;
                 }
               }
             }
@@ -19,6 +19,8 @@
 
 #include "ideal_gas.h"
 
+bool streaming_stores_supported() { return false; }
+
 //  @brief Fortran ideal gas kernel.
 //  @author Wayne Gaudin
 //  @details Calculates the pressure and sound speed for the mesh chunk using
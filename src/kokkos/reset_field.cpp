@@ -18,8 +18,11 @@
  */
 
 #include "reset_field.h"
+#include "perf_counters.h"
 #include "timer.h"
 
+bool fused_summary_supported() { return false; }
+
 //  @brief Fortran reset field kernel.
 //  @author Wayne Gaudin
 //  @details Copies all of the final end of step filed data to the begining of
@@ -54,6 +57,7 @@ void reset_field(global_variables &globals) {
 
   double kernel_time{};
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::reset_field);
 
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
     tile_type &t = globals.chunk.tiles[tile];
@@ -62,5 +66,6 @@ void reset_field(global_variables &globals) {
                        t.field.yvel1.view);
   }
 
+  clover::counters::end(clover::counters::reset_field);
   if (globals.profiler_on) globals.profiler.reset += timer() - kernel_time;
 }
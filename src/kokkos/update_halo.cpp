@@ -21,6 +21,7 @@
 #include "comms.h"
 #include "comms_kernel.h"
 #include "timer.h"
+#include "trace.h"
 #include "update_tile_halo.h"
 
 //   @brief Fortran kernel to update the external halo cells in a chunk.
@@ -635,19 +636,24 @@ void update_halo(global_variables &globals, int fields[NUM_FIELDS], const int de
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::trace::begin("tile_halo_exchange");
   update_tile_halo(globals, fields, depth);
+  clover::trace::end();
   if (globals.profiler_on) {
     globals.profiler.tile_halo_exchange += timer() - kernel_time;
     kernel_time = timer();
   }
 
+  clover::trace::begin("mpi_halo_exchange");
   clover_exchange(globals, fields, depth);
+  clover::trace::end();
 
   if (globals.profiler_on) {
     globals.profiler.mpi_halo_exchange += timer() - kernel_time;
     kernel_time = timer();
   }
 
+  clover::trace::begin("self_halo_exchange");
   if ((globals.chunk.chunk_neighbours[chunk_left] == external_face) || (globals.chunk.chunk_neighbours[chunk_right] == external_face) ||
       (globals.chunk.chunk_neighbours[chunk_bottom] == external_face) || (globals.chunk.chunk_neighbours[chunk_top] == external_face)) {
 
@@ -672,6 +678,7 @@ void update_halo(global_variables &globals, int fields[NUM_FIELDS], const int de
                          fields, depth);
     }
   }
+  clover::trace::end();
 
   if (globals.profiler_on) globals.profiler.self_halo_exchange += timer() - kernel_time;
 }
@@ -18,6 +18,7 @@
  */
 
 #include "accelerate.h"
+#include "perf_counters.h"
 #include "timer.h"
 
 // @brief Fortran acceleration kernel
@@ -90,6 +91,7 @@ void accelerate(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::accelerate);
 
 #if SYNC_BUFFERS
   globals.hostToDevice();
@@ -105,5 +107,6 @@ void accelerate(global_variables &globals) {
   globals.deviceToHost();
 #endif
 
+  clover::counters::end(clover::counters::accelerate);
   if (globals.profiler_on) globals.profiler.acceleration += timer() - kernel_time;
 }
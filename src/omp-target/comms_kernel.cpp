@@ -68,6 +68,9 @@ void clover_allocate_buffers(global_variables &globals, parallel_ &parallel) {
   }
 }
 
+// Fields may live in device memory here, so only the pack path is implemented
+bool clover_exchange_supported(halo_exchange_type type) { return type == halo_exchange_type::pack; }
+
 void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], const int depth) {
 
   // Assuming 1 patch per task, this will be changed
@@ -89,15 +92,16 @@ void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], co
     }
   }
 
-  static clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
+  // Ranks may be threads of one process (see mpi_shim.h), so every thread keeps its own buffers
+  static thread_local clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
 
-  static clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
 
   double *left_rcv = left_rcv_buffer.data;
   double *left_snd = left_snd_buffer.data;
@@ -241,25 +245,25 @@ void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], co
 
 void clover_send_recv_message_left(global_variables &globals, double *left_snd_buffer, double *left_rcv_buffer, int total_size,
                                    int tag_send, int tag_recv, MPI_Request &req_send, MPI_Request &req_recv) {
-  int left_task = globals.chunk.chunk_neighbours[chunk_left] - 1;
-  MPI_Isend(left_snd_buffer, total_size, MPI_DOUBLE, left_task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(left_rcv_buffer, total_size, MPI_DOUBLE, left_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int left_task = globals.chunk.neighbour_task(chunk_left);
+  MPI_Isend(left_snd_buffer, total_size, MPI_DOUBLE, left_task, tag_send, g_comm, &req_send);
+  MPI_Irecv(left_rcv_buffer, total_size, MPI_DOUBLE, left_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_right(global_variables &globals, double *right_snd_buffer, double *right_rcv_buffer, int total_size,
                                     int tag_send, int tag_recv, MPI_Request &req_send, MPI_Request &req_recv) {
-  int right_task = globals.chunk.chunk_neighbours[chunk_right] - 1;
-  MPI_Isend(right_snd_buffer, total_size, MPI_DOUBLE, right_task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(right_rcv_buffer, total_size, MPI_DOUBLE, right_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int right_task = globals.chunk.neighbour_task(chunk_right);
+  MPI_Isend(right_snd_buffer, total_size, MPI_DOUBLE, right_task, tag_send, g_comm, &req_send);
+  MPI_Irecv(right_rcv_buffer, total_size, MPI_DOUBLE, right_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_top(global_variables &globals, double *top_snd_buffer, double *top_rcv_buffer, int total_size, int tag_send,
                                   int tag_recv, MPI_Request &req_send, MPI_Request &req_recv) {
-  int top_task = globals.chunk.chunk_neighbours[chunk_top] - 1;
-  MPI_Isend(top_snd_buffer, total_size, MPI_DOUBLE, top_task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(top_rcv_buffer, total_size, MPI_DOUBLE, top_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int top_task = globals.chunk.neighbour_task(chunk_top);
+  MPI_Isend(top_snd_buffer, total_size, MPI_DOUBLE, top_task, tag_send, g_comm, &req_send);
+  MPI_Irecv(top_rcv_buffer, total_size, MPI_DOUBLE, top_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_bottom(global_variables &globals, double *bottom_snd_buffer, double *bottom_rcv_buffer, int total_size,
                                      int tag_send, int tag_recv, MPI_Request &req_send, MPI_Request &req_recv) {
-  int bottom_task = globals.chunk.chunk_neighbours[chunk_bottom] - 1;
-  MPI_Isend(bottom_snd_buffer, total_size, MPI_DOUBLE, bottom_task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(bottom_rcv_buffer, total_size, MPI_DOUBLE, bottom_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int bottom_task = globals.chunk.neighbour_task(chunk_bottom);
+  MPI_Isend(bottom_snd_buffer, total_size, MPI_DOUBLE, bottom_task, tag_send, g_comm, &req_send);
+  MPI_Irecv(bottom_rcv_buffer, total_size, MPI_DOUBLE, bottom_task, tag_recv, g_comm, &req_recv);
 }
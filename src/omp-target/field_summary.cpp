@@ -18,8 +18,10 @@
  */
 
 #include "field_summary.h"
-#include "ideal_gas.h"
+#include "dirty.h"
+#include "perf_counters.h"
 #include "report.h"
+#include "reproducible.h"
 #include "timer.h"
 
 #include <cmath>
@@ -44,11 +46,11 @@ void field_summary(global_variables &globals, parallel_ &parallel) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::ideal_gas);
 
-  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
-  }
+  clover::dirty::ideal_gas(globals);
 
+  clover::counters::end(clover::counters::ideal_gas);
   if (globals.profiler_on) {
     globals.profiler.ideal_gas += timer() - kernel_time;
     kernel_time = timer();
@@ -114,8 +116,10 @@ void field_summary(global_variables &globals, parallel_ &parallel) {
   clover_sum(ie);
   clover_sum(ke);
   clover_sum(press);
+  // Order independent totals for --reproducible, in place of the ones above
+  if (globals.config.reproducible) clover::repro::field_summary(globals, vol, mass, ie, ke, press);
 
   if (globals.profiler_on) globals.profiler.summary += timer() - kernel_time;
 
-  clover_report_step(globals, parallel, vol, mass, ie, ke, mass);
+  clover_report_step(globals, parallel, vol, mass, ie, ke, press);
 }
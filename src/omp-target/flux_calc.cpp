@@ -18,6 +18,7 @@
  */
 
 #include "flux_calc.h"
+#include "perf_counters.h"
 #include "timer.h"
 
 //  @brief Fortran flux kernel.
@@ -63,6 +64,7 @@ void flux_calc(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::flux_calc);
 
 #if SYNC_BUFFERS
   globals.hostToDevice();
@@ -78,5 +80,6 @@ void flux_calc(global_variables &globals) {
   globals.deviceToHost();
 #endif
 
+  clover::counters::end(clover::counters::flux_calc);
   if (globals.profiler_on) globals.profiler.flux += timer() - kernel_time;
 }
@@ -29,33 +29,8 @@
 
 void generate_chunk(const int tile, global_variables &globals) {
 
-  // Need to copy the host array of state input data into a device array
-  clover::Buffer1D<double> state_density_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_energy_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xvel_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_yvel_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xmin_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xmax_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_ymin_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_ymax_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_radius_buffer(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<int> state_geometry_buffer(globals.context, globals.config.number_of_states);
-
-  // Copy the data to the new views
-  for (int state = 0; state < globals.config.number_of_states; ++state) {
-    state_density_buffer[state] = globals.config.states[state].density;
-    state_energy_buffer[state] = globals.config.states[state].energy;
-    state_xvel_buffer[state] = globals.config.states[state].xvel;
-    state_yvel_buffer[state] = globals.config.states[state].yvel;
-    state_xmin_buffer[state] = globals.config.states[state].xmin;
-    state_xmax_buffer[state] = globals.config.states[state].xmax;
-    state_ymin_buffer[state] = globals.config.states[state].ymin;
-    state_ymax_buffer[state] = globals.config.states[state].ymax;
-    state_radius_buffer[state] = globals.config.states[state].radius;
-    state_geometry_buffer[state] = globals.config.states[state].geometry;
-  }
-
-  // Kokkos::deep_copy (TO, FROM)
+  // States are passed by value into the target regions, so no device state table is needed
+  const std::vector<state_type> &states = globals.config.states;
 
   const int x_min = globals.chunk.tiles[tile].info.t_xmin;
   const int x_max = globals.chunk.tiles[tile].info.t_xmax;
@@ -69,10 +44,10 @@ void generate_chunk(const int tile, global_variables &globals) {
 
   field_type &field = globals.chunk.tiles[tile].field;
 
-  const double state_energy_0 = state_energy_buffer[0];
-  const double state_density_0 = state_density_buffer[0];
-  const double state_xvel_0 = state_xvel_buffer[0];
-  const double state_yvel_0 = state_yvel_buffer[0];
+  const double state_energy_0 = states[0].energy;
+  const double state_density_0 = states[0].density;
+  const double state_xvel_0 = states[0].xvel;
+  const double state_yvel_0 = states[0].yvel;
 
   const int base_stride = field.base_stride;
   const int vels_wk_stride = field.vels_wk_stride;
@@ -94,6 +69,13 @@ void generate_chunk(const int tile, global_variables &globals) {
   }
 
   for (int state = 1; state < globals.config.number_of_states; ++state) {
+    // Only sweep the cells this state can cover
+    const state_extent extent = generate_state_extent(globals, tile, states[state]);
+    if (extent.empty) continue;
+
+    const int fromX = extent.fromX, fromY = extent.fromY;
+    const int toX = extent.toX, toY = extent.toY;
+    const state_type s = states[state];
 
     double *cellx = field.cellx.data;
     double *celly = field.celly.data;
@@ -101,60 +83,44 @@ void generate_chunk(const int tile, global_variables &globals) {
     double *vertexx = field.vertexx.data;
     double *vertexy = field.vertexy.data;
 
-    const double *state_density = state_density_buffer.data;
-    const double *state_energy = state_energy_buffer.data;
-    const double *state_xvel = state_xvel_buffer.data;
-    const double *state_yvel = state_yvel_buffer.data;
-    const double *state_xmin = state_xmin_buffer.data;
-    const double *state_xmax = state_xmax_buffer.data;
-    const double *state_ymin = state_ymin_buffer.data;
-    const double *state_ymax = state_ymax_buffer.data;
-    const double *state_radius = state_radius_buffer.data;
-    const int *state_geometry = state_geometry_buffer.data;
-
-#pragma omp target teams distribute parallel for simd collapse(2) clover_use_target(globals.context.use_target)                            \
-    map(to : state_density[ : state_density_buffer.N()]) map(to : state_energy[ : state_energy_buffer.N()])                                \
-    map(to : state_xvel[ : state_xvel_buffer.N()]) map(to : state_yvel[ : state_yvel_buffer.N()])                                          \
-    map(to : state_xmin[ : state_xmin_buffer.N()]) map(to : state_xmax[ : state_xmax_buffer.N()])                                          \
-    map(to : state_ymin[ : state_ymin_buffer.N()]) map(to : state_ymax[ : state_ymax_buffer.N()])                                          \
-    map(to : state_radius[ : state_radius_buffer.N()]) map(to : state_geometry[ : state_geometry_buffer.N()])
-    for (int j = 0; j < (yrange); j++) {
-      for (int i = 0; i < (xrange); i++) {
-        double x_cent = state_xmin[state];
-        double y_cent = state_ymin[state];
-        if (state_geometry[state] == g_rect) {
-          if (vertexx[i + 1] >= state_xmin[state] && vertexx[i] < state_xmax[state]) {
-            if (vertexy[j + 1] >= state_ymin[state] && vertexy[j] < state_ymax[state]) {
-              energy0[i + j * base_stride] = state_energy[state];
-              density0[i + j * base_stride] = state_density[state];
+#pragma omp target teams distribute parallel for simd collapse(2) clover_use_target(globals.context.use_target) firstprivate(s)
+    for (int j = fromY; j < toY; j++) {
+      for (int i = fromX; i < toX; i++) {
+        double x_cent = s.xmin;
+        double y_cent = s.ymin;
+        if (s.geometry == g_rect) {
+          if (vertexx[i + 1] >= s.xmin && vertexx[i] < s.xmax) {
+            if (vertexy[j + 1] >= s.ymin && vertexy[j] < s.ymax) {
+              energy0[i + j * base_stride] = s.energy;
+              density0[i + j * base_stride] = s.density;
               for (int kt = j; kt <= j + 1; ++kt) {
                 for (int jt = i; jt <= i + 1; ++jt) {
-                  xvel0[jt + kt * vels_wk_stride] = state_xvel[state];
-                  yvel0[jt + kt * vels_wk_stride] = state_yvel[state];
+                  xvel0[jt + kt * vels_wk_stride] = s.xvel;
+                  yvel0[jt + kt * vels_wk_stride] = s.yvel;
                 }
               }
             }
           }
-        } else if (state_geometry[state] == g_circ) {
+        } else if (s.geometry == g_circ) {
           double radius = sqrt((cellx[i] - x_cent) * (cellx[i] - x_cent) + (celly[j] - y_cent) * (celly[j] - y_cent));
-          if (radius <= state_radius[state]) {
-            energy0[i + j * base_stride] = state_energy[state];
-            density0[i + j * base_stride] = state_density[state];
+          if (radius <= s.radius) {
+            energy0[i + j * base_stride] = s.energy;
+            density0[i + j * base_stride] = s.density;
             for (int kt = j; kt <= j + 1; ++kt) {
               for (int jt = i; jt <= i + 1; ++jt) {
-                xvel0[jt + kt * vels_wk_stride] = state_xvel[state];
-                yvel0[jt + kt * vels_wk_stride] = state_yvel[state];
+                xvel0[jt + kt * vels_wk_stride] = s.xvel;
+                yvel0[jt + kt * vels_wk_stride] = s.yvel;
               }
             }
           }
-        } else if (state_geometry[state] == g_point) {
+        } else if (s.geometry == g_point) {
           if (vertexx[i] == x_cent && vertexy[j] == y_cent) {
-            energy0[i + j * base_stride] = state_energy[state];
-            density0[i + j * base_stride] = state_density[state];
+            energy0[i + j * base_stride] = s.energy;
+            density0[i + j * base_stride] = s.density;
             for (int kt = j; kt <= j + 1; ++kt) {
               for (int jt = i; jt <= i + 1; ++jt) {
-                xvel0[jt + kt * vels_wk_stride] = state_xvel[state];
-                yvel0[jt + kt * vels_wk_stride] = state_yvel[state];
+                xvel0[jt + kt * vels_wk_stride] = s.xvel;
+                yvel0[jt + kt * vels_wk_stride] = s.yvel;
               }
             }
           }
@@ -18,8 +18,11 @@
  */
 
 #include "reset_field.h"
+#include "perf_counters.h"
 #include "timer.h"
 
+bool fused_summary_supported() { return false; }
+
 //  @brief Fortran reset field kernel.
 //  @author Wayne Gaudin
 //  @details Copies all of the final end of step filed data to the begining of
@@ -66,6 +69,7 @@ void reset_field(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::reset_field);
 
 #if SYNC_BUFFERS
   globals.hostToDevice();
@@ -81,5 +85,6 @@ void reset_field(global_variables &globals) {
   globals.deviceToHost();
 #endif
 
+  clover::counters::end(clover::counters::reset_field);
   if (globals.profiler_on) globals.profiler.reset += timer() - kernel_time;
 }
@@ -19,7 +19,81 @@
 
 #include "advec_cell.h"
 #include "context.h"
+#include "simd.h"
 #include <cmath>
+#include <cstddef>
+
+bool advec_simd_supported() { return true; }
+
+//  @brief Branch free van Leer flux through a face of the cell sweep.
+//  @details Computes the mass and energy flux for one face, or one vector of
+//  faces, from the cells at -2, -1, 0 and up (1, or 0 on the last face where
+//  the upwind cell is clamped) steps of stride s_cell (density, energy) or
+//  s_work (pre_vol) along the sweep. The sign of the volume flux picks the
+//  upwind, donor and downwind cells with blends rather than index branches,
+//  so the whole stencil is loaded once and every lane runs the same code.
+template <typename T>
+static inline void advec_cell_face(const double *vol_flux, const double *pre_vol, const double *density1, const double *energy1,
+                                   std::ptrdiff_t s_cell, std::ptrdiff_t s_work, int up, T vertexd, T vertexd_before, T vertexd_after,
+                                   double *mass_flux, double *ener_flux) {
+  using clover::simd::abs;
+  using clover::simd::load_as;
+  using clover::simd::min;
+  using clover::simd::select;
+  const double one_by_six = 1.0 / 6.0;
+
+  const auto limited = [&](T sigma, T sigma3, T sigma4, T diffuw, T diffdw) {
+    T wind = select(diffdw <= 0.0, T(-1.0), T(1.0));
+    T auw = abs(diffuw), adw = abs(diffdw);
+    T limiter = (1.0 - sigma) * wind * min(min(auw, adw), one_by_six * (sigma3 * auw + sigma4 * adw));
+    return select(diffuw * diffdw > 0.0, limiter, T(0.0));
+  };
+
+  T flux = load_as<T>(vol_flux);
+  auto forward = flux > 0.0;
+  T pre_vol_donor = select(forward, load_as<T>(pre_vol - s_work), load_as<T>(pre_vol));
+
+  T sigmat = abs(flux) / pre_vol_donor;
+  T sigma3 = (1.0 + sigmat) * (vertexd / select(forward, vertexd_before, vertexd_after));
+  T sigma4 = 2.0 - sigmat;
+
+  T before = load_as<T>(density1 - 2 * s_cell), donor_before = load_as<T>(density1 - s_cell);
+  T here = load_as<T>(density1), after = load_as<T>(density1 + up * s_cell);
+  T upwind = select(forward, before, after), donor = select(forward, donor_before, here), downwind = select(forward, here, donor_before);
+  T mass = flux * (donor + limited(sigmat, sigma3, sigma4, donor - upwind, downwind - donor));
+  T sigmam = abs(mass) / (donor * pre_vol_donor);
+
+  before = load_as<T>(energy1 - 2 * s_cell), donor_before = load_as<T>(energy1 - s_cell);
+  here = load_as<T>(energy1), after = load_as<T>(energy1 + up * s_cell);
+  upwind = select(forward, before, after), donor = select(forward, donor_before, here), downwind = select(forward, here, donor_before);
+  clover::simd::store(mass_flux, mass);
+  clover::simd::store(ener_flux, mass * (donor + limited(sigmam, sigma3, sigma4, donor - upwind, downwind - donor)));
+}
+
+//  @brief Volumes of a cell sweep with streamed stores.
+//  @details Same arithmetic as the pre_vol and post_vol loops of the kernel,
+//  with own the volume flux along the sweep and other the one across it, each
+//  with the offset to its next face.
+static void advec_cell_volumes_streamed(int x_min, int x_max, int y_min, int y_max, bool first_sweep, const clover::Buffer2D<double> &volume,
+                                        const clover::Buffer2D<double> &own, std::ptrdiff_t own_next, const clover::Buffer2D<double> &other,
+                                        std::ptrdiff_t other_next, clover::Buffer2D<double> &pre_vol, clover::Buffer2D<double> &post_vol) {
+  using clover::simd::load_as;
+  using clover::simd::stream;
+  clover::simd::stream_rows(pre_vol.data, pre_vol.sizeX, x_min - 2 + 1, x_max + 2 + 2, y_min - 2 + 1, y_max + 2 + 2, [&](int i, int j, auto lane) {
+    using T = decltype(lane);
+    const double *o = &own(i, j), *t = &other(i, j);
+    T vol = load_as<T>(&volume(i, j));
+    if (first_sweep) {
+      T own_diff = load_as<T>(o + own_next) - load_as<T>(o);
+      T pre = vol + (own_diff + load_as<T>(t + other_next) - load_as<T>(t));
+      stream(&pre_vol(i, j), pre);
+      stream(&post_vol(i, j), pre - own_diff);
+    } else {
+      stream(&pre_vol(i, j), vol + load_as<T>(o + own_next) - load_as<T>(o));
+      stream(&post_vol(i, j), vol);
+    }
+  });
+}
 
 //  @brief Fortran cell advection kernel.
 //  @author Wayne Gaudin
@@ -30,16 +104,23 @@ void advec_cell_kernel(int x_min, int x_max, int y_min, int y_max, int dir, int
                        clover::Buffer2D<double> &energy1, clover::Buffer2D<double> &mass_flux_x, clover::Buffer2D<double> &vol_flux_x,
                        clover::Buffer2D<double> &mass_flux_y, clover::Buffer2D<double> &vol_flux_y, clover::Buffer2D<double> &pre_vol,
                        clover::Buffer2D<double> &post_vol, clover::Buffer2D<double> &pre_mass, clover::Buffer2D<double> &post_mass,
-                       clover::Buffer2D<double> &advec_vol, clover::Buffer2D<double> &post_ener, clover::Buffer2D<double> &ener_flux) {
+                       clover::Buffer2D<double> &advec_vol, clover::Buffer2D<double> &post_ener, clover::Buffer2D<double> &ener_flux,
+                       bool simd, bool streaming) {
 
   const double one_by_six = 1.0 / 6.0;
+  const auto s_cell = static_cast<std::ptrdiff_t>(density1.sizeX), s_work = static_cast<std::ptrdiff_t>(pre_vol.sizeX);
+  constexpr int width = clover::simd::width;
+  using clover::simd::vec;
 
   if (dir == g_xdir) {
 
     // DO k=y_min-2,y_max+2
     //   DO j=x_min-2,x_max+2
 
-    if (sweep_number == 1) {
+    if (streaming) {
+      advec_cell_volumes_streamed(x_min, x_max, y_min, y_max, sweep_number == 1, volume, vol_flux_x, 1, vol_flux_y,
+                                  static_cast<std::ptrdiff_t>(vol_flux_y.sizeX), pre_vol, post_vol);
+    } else if (sweep_number == 1) {
 
 #pragma omp parallel for simd collapse(2)
       for (int j = (y_min - 2 + 1); j < (y_max + 2 + 2); j++) {
@@ -62,53 +143,70 @@ void advec_cell_kernel(int x_min, int x_max, int y_min, int y_max, int dir, int
 
 // DO k=y_min,y_max
 //   DO j=x_min,x_max+2
+    if (simd) {
+      // The last face clamps its upwind cell, so it is left to the scalar remainder
+#pragma omp parallel for
+      for (int j = (y_min + 1); j < (y_max + 2); j++) {
+        int i = x_min + 1;
+        for (; i + width <= x_max + 3; i += width)
+          advec_cell_face<vec>(&vol_flux_x(i, j), &pre_vol(i, j), &density1(i, j), &energy1(i, j), 1, 1, 1,
+                               clover::simd::load(&vertexdx[i]), clover::simd::load(&vertexdx[i - 1]),
+                               clover::simd::load(&vertexdx[i + 1]), &mass_flux_x(i, j), &ener_flux(i, j));
+        for (; i < (x_max + 2 + 2); i++) {
+          int up = i + 1 <= x_max + 3 ? 1 : 0;
+          advec_cell_face<double>(&vol_flux_x(i, j), &pre_vol(i, j), &density1(i, j), &energy1(i, j), 1, 1, up, vertexdx[i],
+                                  vertexdx[i - 1], vertexdx[i + up], &mass_flux_x(i, j), &ener_flux(i, j));
+        }
+      }
+    } else {
 #pragma omp parallel for simd collapse(2)
-    for (int j = (y_min + 1); j < (y_max + 2); j++) {
-      for (int i = (x_min + 1); i < (x_max + 2 + 2); i++)
-        ({
-          int upwind, donor, downwind, dif;
-          double sigmat, sigma3, sigma4, sigmav, sigmam, diffuw, diffdw, limiter, wind;
-          if (vol_flux_x(i, j) > 0.0) {
-            upwind = i - 2;
-            donor = i - 1;
-            downwind = i;
-            dif = donor;
-          } else {
-            upwind = std::min(i + 1, x_max + 2);
-            donor = i;
-            downwind = i - 1;
-            dif = upwind;
-          }
-          sigmat = std::fabs(vol_flux_x(i, j)) / pre_vol(donor, j);
-          sigma3 = (1.0 + sigmat) * (vertexdx[i] / vertexdx[dif]);
-          sigma4 = 2.0 - sigmat;
-          sigmav = sigmat;
-          diffuw = density1(donor, j) - density1(upwind, j);
-          diffdw = density1(downwind, j) - density1(donor, j);
-          wind = 1.0;
-          if (diffdw <= 0.0) wind = -1.0;
-          if (diffuw * diffdw > 0.0) {
-            limiter = (1.0 - sigmav) * wind *
-                      std::fmin(std::fmin(std::fabs(diffuw), std::fabs(diffdw)),
-                                one_by_six * (sigma3 * std::fabs(diffuw) + sigma4 * std::fabs(diffdw)));
-          } else {
-            limiter = 0.0;
-          }
-          mass_flux_x(i, j) = vol_flux_x(i, j) * (density1(donor, j) + limiter);
-          sigmam = std::fabs(mass_flux_x(i, j)) / (density1(donor, j) * pre_vol(donor, j));
-          diffuw = energy1(donor, j) - energy1(upwind, j);
-          diffdw = energy1(downwind, j) - energy1(donor, j);
-          wind = 1.0;
-          if (diffdw <= 0.0) wind = -1.0;
-          if (diffuw * diffdw > 0.0) {
-            limiter = (1.0 - sigmam) * wind *
-                      std::fmin(std::fmin(std::fabs(diffuw), std::fabs(diffdw)),
-                                one_by_six * (sigma3 * std::fabs(diffuw) + sigma4 * std::fabs(diffdw)));
-          } else {
-            limiter = 0.0;
-          }
-          ener_flux(i, j) = mass_flux_x(i, j) * (energy1(donor, j) + limiter);
-        });
+      for (int j = (y_min + 1); j < (y_max + 2); j++) {
+        for (int i = (x_min + 1); i < (x_max + 2 + 2); i++)
+          ({
+            int upwind, donor, downwind, dif;
+            double sigmat, sigma3, sigma4, sigmav, sigmam, diffuw, diffdw, limiter, wind;
+            if (vol_flux_x(i, j) > 0.0) {
+              upwind = i - 2;
+              donor = i - 1;
+              downwind = i;
+              dif = donor;
+            } else {
+              upwind = std::min(i + 1, x_max + 3);
+              donor = i;
+              downwind = i - 1;
+              dif = upwind;
+            }
+            sigmat = std::fabs(vol_flux_x(i, j)) / pre_vol(donor, j);
+            sigma3 = (1.0 + sigmat) * (vertexdx[i] / vertexdx[dif]);
+            sigma4 = 2.0 - sigmat;
+            sigmav = sigmat;
+            diffuw = density1(donor, j) - density1(upwind, j);
+            diffdw = density1(downwind, j) - density1(donor, j);
+            wind = 1.0;
+            if (diffdw <= 0.0) wind = -1.0;
+            if (diffuw * diffdw > 0.0) {
+              limiter = (1.0 - sigmav) * wind *
+                        std::fmin(std::fmin(std::fabs(diffuw), std::fabs(diffdw)),
+                                  one_by_six * (sigma3 * std::fabs(diffuw) + sigma4 * std::fabs(diffdw)));
+            } else {
+              limiter = 0.0;
+            }
+            mass_flux_x(i, j) = vol_flux_x(i, j) * (density1(donor, j) + limiter);
+            sigmam = std::fabs(mass_flux_x(i, j)) / (density1(donor, j) * pre_vol(donor, j));
+            diffuw = energy1(donor, j) - energy1(upwind, j);
+            diffdw = energy1(downwind, j) - energy1(donor, j);
+            wind = 1.0;
+            if (diffdw <= 0.0) wind = -1.0;
+            if (diffuw * diffdw > 0.0) {
+              limiter = (1.0 - sigmam) * wind *
+                        std::fmin(std::fmin(std::fabs(diffuw), std::fabs(diffdw)),
+                                  one_by_six * (sigma3 * std::fabs(diffuw) + sigma4 * std::fabs(diffdw)));
+            } else {
+              limiter = 0.0;
+            }
+            ener_flux(i, j) = mass_flux_x(i, j) * (energy1(donor, j) + limiter);
+          });
+      }
     }
 
     // DO k=y_min,y_max
@@ -131,7 +229,10 @@ void advec_cell_kernel(int x_min, int x_max, int y_min, int y_max, int dir, int
     // DO k=y_min-2,y_max+2
     //   DO j=x_min-2,x_max+2
 
-    if (sweep_number == 1) {
+    if (streaming) {
+      advec_cell_volumes_streamed(x_min, x_max, y_min, y_max, sweep_number == 1, volume, vol_flux_y,
+                                  static_cast<std::ptrdiff_t>(vol_flux_y.sizeX), vol_flux_x, 1, pre_vol, post_vol);
+    } else if (sweep_number == 1) {
 
 #pragma omp parallel for simd collapse(2)
       for (int j = (y_min - 2 + 1); j < (y_max + 2 + 2); j++) {
@@ -154,53 +255,67 @@ void advec_cell_kernel(int x_min, int x_max, int y_min, int y_max, int dir, int
 
 // DO k=y_min,y_max+2
 //   DO j=x_min,x_max
+    if (simd) {
+#pragma omp parallel for
+      for (int j = (y_min + 1); j < (y_max + 2 + 2); j++) {
+        int up = j + 1 <= y_max + 3 ? 1 : 0;
+        int i = x_min + 1;
+        for (; i + width <= x_max + 2; i += width)
+          advec_cell_face<vec>(&vol_flux_y(i, j), &pre_vol(i, j), &density1(i, j), &energy1(i, j), s_cell, s_work, up, vertexdy[j],
+                               vertexdy[j - 1], vertexdy[j + up], &mass_flux_y(i, j), &ener_flux(i, j));
+        for (; i < (x_max + 2); i++)
+          advec_cell_face<double>(&vol_flux_y(i, j), &pre_vol(i, j), &density1(i, j), &energy1(i, j), s_cell, s_work, up, vertexdy[j],
+                                  vertexdy[j - 1], vertexdy[j + up], &mass_flux_y(i, j), &ener_flux(i, j));
+      }
+    } else {
 #pragma omp parallel for simd collapse(2)
-    for (int j = (y_min + 1); j < (y_max + 2 + 2); j++) {
-      for (int i = (x_min + 1); i < (x_max + 2); i++)
-        ({
-          int upwind, donor, downwind, dif;
-          double sigmat, sigma3, sigma4, sigmav, sigmam, diffuw, diffdw, limiter, wind;
-          if (vol_flux_y(i, j) > 0.0) {
-            upwind = j - 2;
-            donor = j - 1;
-            downwind = j;
-            dif = donor;
-          } else {
-            upwind = std::min(j + 1, y_max + 2);
-            donor = j;
-            downwind = j - 1;
-            dif = upwind;
-          }
-          sigmat = std::fabs(vol_flux_y(i, j)) / pre_vol(i, donor);
-          sigma3 = (1.0 + sigmat) * (vertexdy[j] / vertexdy[dif]);
-          sigma4 = 2.0 - sigmat;
-          sigmav = sigmat;
-          diffuw = density1(i, donor) - density1(i, upwind);
-          diffdw = density1(i, downwind) - density1(i, donor);
-          wind = 1.0;
-          if (diffdw <= 0.0) wind = -1.0;
-          if (diffuw * diffdw > 0.0) {
-            limiter = (1.0 - sigmav) * wind *
-                      std::fmin(std::fmin(std::fabs(diffuw), std::fabs(diffdw)),
-                                one_by_six * (sigma3 * std::fabs(diffuw) + sigma4 * std::fabs(diffdw)));
-          } else {
-            limiter = 0.0;
-          }
-          mass_flux_y(i, j) = vol_flux_y(i, j) * (density1(i, donor) + limiter);
-          sigmam = std::fabs(mass_flux_y(i, j)) / (density1(i, donor) * pre_vol(i, donor));
-          diffuw = energy1(i, donor) - energy1(i, upwind);
-          diffdw = energy1(i, downwind) - energy1(i, donor);
-          wind = 1.0;
-          if (diffdw <= 0.0) wind = -1.0;
-          if (diffuw * diffdw > 0.0) {
-            limiter = (1.0 - sigmam) * wind *
-                      std::fmin(std::fmin(std::fabs(diffuw), std::fabs(diffdw)),
-                                one_by_six * (sigma3 * std::fabs(diffuw) + sigma4 * std::fabs(diffdw)));
-          } else {
-            limiter = 0.0;
-          }
-          ener_flux(i, j) = mass_flux_y(i, j) * (energy1(i, donor) + limiter);
-        });
+      for (int j = (y_min + 1); j < (y_max + 2 + 2); j++) {
+        for (int i = (x_min + 1); i < (x_max + 2); i++)
+          ({
+            int upwind, donor, downwind, dif;
+            double sigmat, sigma3, sigma4, sigmav, sigmam, diffuw, diffdw, limiter, wind;
+            if (vol_flux_y(i, j) > 0.0) {
+              upwind = j - 2;
+              donor = j - 1;
+              downwind = j;
+              dif = donor;
+            } else {
+              upwind = std::min(j + 1, y_max + 3);
+              donor = j;
+              downwind = j - 1;
+              dif = upwind;
+            }
+            sigmat = std::fabs(vol_flux_y(i, j)) / pre_vol(i, donor);
+            sigma3 = (1.0 + sigmat) * (vertexdy[j] / vertexdy[dif]);
+            sigma4 = 2.0 - sigmat;
+            sigmav = sigmat;
+            diffuw = density1(i, donor) - density1(i, upwind);
+            diffdw = density1(i, downwind) - density1(i, donor);
+            wind = 1.0;
+            if (diffdw <= 0.0) wind = -1.0;
+            if (diffuw * diffdw > 0.0) {
+              limiter = (1.0 - sigmav) * wind *
+                        std::fmin(std::fmin(std::fabs(diffuw), std::fabs(diffdw)),
+                                  one_by_six * (sigma3 * std::fabs(diffuw) + sigma4 * std::fabs(diffdw)));
+            } else {
+              limiter = 0.0;
+            }
+            mass_flux_y(i, j) = vol_flux_y(i, j) * (density1(i, donor) + limiter);
+            sigmam = std::fabs(mass_flux_y(i, j)) / (density1(i, donor) * pre_vol(i, donor));
+            diffuw = energy1(i, donor) - energy1(i, upwind);
+            diffdw = energy1(i, downwind) - energy1(i, donor);
+            wind = 1.0;
+            if (diffdw <= 0.0) wind = -1.0;
+            if (diffuw * diffdw > 0.0) {
+              limiter = (1.0 - sigmam) * wind *
+                        std::fmin(std::fmin(std::fabs(diffuw), std::fabs(diffdw)),
+                                  one_by_six * (sigma3 * std::fabs(diffuw) + sigma4 * std::fabs(diffdw)));
+            } else {
+              limiter = 0.0;
+            }
+            ener_flux(i, j) = mass_flux_y(i, j) * (energy1(i, donor) + limiter);
+          });
+      }
     }
 
 // DO k=y_min,y_max
@@ -228,5 +343,6 @@ void advec_cell_driver(global_variables &globals, int tile, int sweep_number, in
   advec_cell_kernel(t.info.t_xmin, t.info.t_xmax, t.info.t_ymin, t.info.t_ymax, direction, sweep_number, t.field.vertexdx, t.field.vertexdy,
                     t.field.volume, t.field.density1, t.field.energy1, t.field.mass_flux_x, t.field.vol_flux_x, t.field.mass_flux_y,
                     t.field.vol_flux_y, t.field.work_array1, t.field.work_array2, t.field.work_array3, t.field.work_array4,
-                    t.field.work_array5, t.field.work_array6, t.field.work_array7);
+                    t.field.work_array5, t.field.work_array6, t.field.work_array7,
+                    globals.advection_kernel == advection_kernel_type::simd, globals.stores == store_type::streaming);
 }
@@ -19,7 +19,62 @@
 
 #include "advec_mom.h"
 #include "context.h"
+#include "simd.h"
 #include <cmath>
+#include <cstddef>
+
+//  @brief Branch free van Leer momentum flux through a node face of the sweep.
+//  @details Computes mom_flux for one node, or one vector of nodes, from the
+//  velocities at -1, 0, 1 and 2 steps of stride s_vel along the sweep. The
+//  sign of the node flux picks the upwind, donor and downwind nodes (and the
+//  cell width of the limiter) with blends, see advec_cell_face.
+template <typename T>
+static inline void advec_mom_face(const double *node_flux, const double *node_mass_pre, const double *vel1, std::ptrdiff_t s_work,
+                                  std::ptrdiff_t s_vel, T width, T celld_before, T celld_after, double *mom_flux) {
+  using clover::simd::abs;
+  using clover::simd::load_as;
+  using clover::simd::min;
+  using clover::simd::select;
+
+  T flux = load_as<T>(node_flux);
+  auto backward = flux < 0.0;
+  T before = load_as<T>(vel1 - s_vel), here = load_as<T>(vel1), after = load_as<T>(vel1 + s_vel), beyond = load_as<T>(vel1 + 2 * s_vel);
+  T upwind = select(backward, beyond, before), donor = select(backward, after, here), downwind = select(backward, here, after);
+
+  T sigma = abs(flux) / select(backward, load_as<T>(node_mass_pre + s_work), load_as<T>(node_mass_pre));
+  T vdiffuw = donor - upwind;
+  T vdiffdw = downwind - donor;
+  T auw = abs(vdiffuw), adw = abs(vdiffdw);
+  T wind = select(vdiffdw <= 0.0, T(-1.0), T(1.0));
+  T celld = select(backward, celld_after, celld_before);
+  T limiter = wind * min(min(width * ((2.0 - sigma) * adw / width + (1.0 + sigma) * auw / celld) / 6.0, auw), adw);
+  limiter = select(vdiffuw * vdiffdw > 0.0, limiter, T(0.0));
+  clover::simd::store(mom_flux, (donor + (1.0 - sigma) * limiter) * flux);
+}
+
+//  @brief Volumes of a momentum sweep with streamed stores.
+//  @details Same arithmetic as the post_vol and pre_vol loops of the kernel:
+//  post_vol is the volume plus the difference of post_flux, if there is one, and
+//  pre_vol adds the difference of pre_flux to that. Each flux comes with the
+//  offset to its next face.
+static void advec_mom_volumes_streamed(int x_min, int x_max, int y_min, int y_max, const clover::Buffer2D<double> &volume,
+                                       const clover::Buffer2D<double> *post_flux, std::ptrdiff_t post_next,
+                                       const clover::Buffer2D<double> &pre_flux, std::ptrdiff_t pre_next, clover::Buffer2D<double> &pre_vol,
+                                       clover::Buffer2D<double> &post_vol) {
+  using clover::simd::load_as;
+  using clover::simd::stream;
+  clover::simd::stream_rows(post_vol.data, post_vol.sizeX, x_min - 2 + 1, x_max + 2 + 2, y_min - 2 + 1, y_max + 2 + 2, [&](int i, int j, auto lane) {
+    using T = decltype(lane);
+    T post = load_as<T>(&volume(i, j));
+    if (post_flux) {
+      const double *f = &(*post_flux)(i, j);
+      post = post + load_as<T>(f + post_next) - load_as<T>(f);
+    }
+    const double *f = &pre_flux(i, j);
+    stream(&post_vol(i, j), post);
+    stream(&pre_vol(i, j), post + load_as<T>(f + pre_next) - load_as<T>(f));
+  });
+}
 
 //  @brief Fortran momentum advection kernel
 //  @author Wayne Gaudin
@@ -32,14 +87,23 @@ void advec_mom_kernel(int x_min, int x_max, int y_min, int y_max, clover::Buffer
                       clover::Buffer2D<double> &volume, clover::Buffer2D<double> &density1, clover::Buffer2D<double> &node_flux,
                       clover::Buffer2D<double> &node_mass_post, clover::Buffer2D<double> &node_mass_pre, clover::Buffer2D<double> &mom_flux,
                       clover::Buffer2D<double> &pre_vol, clover::Buffer2D<double> &post_vol, clover::Buffer1D<double> &celldx,
-                      clover::Buffer1D<double> &celldy, int which_vel, int sweep_number, int direction) {
+                      clover::Buffer1D<double> &celldy, int which_vel, int sweep_number, int direction, bool simd, bool streaming) {
 
   int mom_sweep = direction + 2 * (sweep_number - 1);
+  const auto s_work = static_cast<std::ptrdiff_t>(node_flux.sizeX), s_vel = static_cast<std::ptrdiff_t>(vel1.sizeX);
+  constexpr int width = clover::simd::width;
+  using clover::simd::vec;
 
   // DO k=y_min-2,y_max+2
   //   DO j=x_min-2,x_max+2
 
-  if (mom_sweep == 1) { // x 1
+  const auto s_flux_y = static_cast<std::ptrdiff_t>(vol_flux_y.sizeX);
+  if (streaming) {
+    const clover::Buffer2D<double> *post_flux = mom_sweep == 1 ? &vol_flux_y : mom_sweep == 2 ? &vol_flux_x : nullptr;
+    bool pre_along_x = mom_sweep == 1 || mom_sweep == 4;
+    advec_mom_volumes_streamed(x_min, x_max, y_min, y_max, volume, post_flux, mom_sweep == 1 ? s_flux_y : 1,
+                               pre_along_x ? vol_flux_x : vol_flux_y, pre_along_x ? 1 : s_flux_y, pre_vol, post_vol);
+  } else if (mom_sweep == 1) { // x 1
 
 #pragma omp parallel for simd collapse(2)
     for (int j = (y_min - 2 + 1); j < (y_max + 2 + 2); j++) {
@@ -105,39 +169,52 @@ void advec_mom_kernel(int x_min, int x_max, int y_min, int y_max, clover::Buffer
     // DO k=y_min,y_max+1
     //  DO j=x_min-1,x_max+1
 
+    if (simd) {
+#pragma omp parallel for
+      for (int j = (y_min + 1); j < (y_max + 1 + 2); j++) {
+        int i = x_min - 1 + 1;
+        for (; i + width <= x_max + 1 + 2; i += width)
+          advec_mom_face<vec>(&node_flux(i, j), &node_mass_pre(i, j), &vel1(i, j), 1, 1, clover::simd::load(&celldx[i]),
+                              clover::simd::load(&celldx[i - 1]), clover::simd::load(&celldx[i + 1]), &mom_flux(i, j));
+        for (; i < (x_max + 1 + 2); i++)
+          advec_mom_face<double>(&node_flux(i, j), &node_mass_pre(i, j), &vel1(i, j), 1, 1, celldx[i], celldx[i - 1], celldx[i + 1],
+                                 &mom_flux(i, j));
+      }
+    } else {
 #pragma omp parallel for simd collapse(2)
-    for (int j = (y_min + 1); j < (y_max + 1 + 2); j++) {
-      for (int i = (x_min - 1 + 1); i < (x_max + 1 + 2); i++)
-        ({
-          int upwind, donor, downwind, dif;
-          double sigma, width, limiter, vdiffuw, vdiffdw, auw, adw, wind, advec_vel_s;
-          if (node_flux(i, j) < 0.0) {
-            upwind = i + 2;
-            donor = i + 1;
-            downwind = i;
-            dif = donor;
-          } else {
-            upwind = i - 1;
-            donor = i;
-            downwind = i + 1;
-            dif = upwind;
-          }
-          sigma = std::fabs(node_flux(i, j)) / (node_mass_pre(donor, j));
-          width = celldx[i];
-          vdiffuw = vel1(donor, j) - vel1(upwind, j);
-          vdiffdw = vel1(downwind, j) - vel1(donor, j);
-          limiter = 0.0;
-          if (vdiffuw * vdiffdw > 0.0) {
-            auw = std::fabs(vdiffuw);
-            adw = std::fabs(vdiffdw);
-            wind = 1.0;
-            if (vdiffdw <= 0.0) wind = -1.0;
-            limiter =
-                wind * std::fmin(std::fmin(width * ((2.0 - sigma) * adw / width + (1.0 + sigma) * auw / celldx[dif]) / 6.0, auw), adw);
-          }
-          advec_vel_s = vel1(donor, j) + (1.0 - sigma) * limiter;
-          mom_flux(i, j) = advec_vel_s * node_flux(i, j);
-        });
+      for (int j = (y_min + 1); j < (y_max + 1 + 2); j++) {
+        for (int i = (x_min - 1 + 1); i < (x_max + 1 + 2); i++)
+          ({
+            int upwind, donor, downwind, dif;
+            double sigma, width, limiter, vdiffuw, vdiffdw, auw, adw, wind, advec_vel_s;
+            if (node_flux(i, j) < 0.0) {
+              upwind = i + 2;
+              donor = i + 1;
+              downwind = i;
+              dif = donor;
+            } else {
+              upwind = i - 1;
+              donor = i;
+              downwind = i + 1;
+              dif = upwind;
+            }
+            sigma = std::fabs(node_flux(i, j)) / (node_mass_pre(donor, j));
+            width = celldx[i];
+            vdiffuw = vel1(donor, j) - vel1(upwind, j);
+            vdiffdw = vel1(downwind, j) - vel1(donor, j);
+            limiter = 0.0;
+            if (vdiffuw * vdiffdw > 0.0) {
+              auw = std::fabs(vdiffuw);
+              adw = std::fabs(vdiffdw);
+              wind = 1.0;
+              if (vdiffdw <= 0.0) wind = -1.0;
+              limiter =
+                  wind * std::fmin(std::fmin(width * ((2.0 - sigma) * adw / width + (1.0 + sigma) * auw / celldx[dif]) / 6.0, auw), adw);
+            }
+            advec_vel_s = vel1(donor, j) + (1.0 - sigma) * limiter;
+            mom_flux(i, j) = advec_vel_s * node_flux(i, j);
+          });
+      }
     }
 
     // DO k=y_min,y_max+1
@@ -177,39 +254,52 @@ void advec_mom_kernel(int x_min, int x_max, int y_min, int y_max, clover::Buffer
     // DO k=y_min-1,y_max+1
     //   DO j=x_min,x_max+1
 
+    if (simd) {
+#pragma omp parallel for
+      for (int j = (y_min - 1 + 1); j < (y_max + 1 + 2); j++) {
+        int i = x_min + 1;
+        for (; i + width <= x_max + 1 + 2; i += width)
+          advec_mom_face<vec>(&node_flux(i, j), &node_mass_pre(i, j), &vel1(i, j), s_work, s_vel, celldy[j], celldy[j - 1], celldy[j + 1],
+                              &mom_flux(i, j));
+        for (; i < (x_max + 1 + 2); i++)
+          advec_mom_face<double>(&node_flux(i, j), &node_mass_pre(i, j), &vel1(i, j), s_work, s_vel, celldy[j], celldy[j - 1],
+                                 celldy[j + 1], &mom_flux(i, j));
+      }
+    } else {
 #pragma omp parallel for simd collapse(2)
-    for (int j = (y_min - 1 + 1); j < (y_max + 1 + 2); j++) {
-      for (int i = (x_min + 1); i < (x_max + 1 + 2); i++)
-        ({
-          int upwind, donor, downwind, dif;
-          double sigma, width, limiter, vdiffuw, vdiffdw, auw, adw, wind, advec_vel_s;
-          if (node_flux(i, j) < 0.0) {
-            upwind = j + 2;
-            donor = j + 1;
-            downwind = j;
-            dif = donor;
-          } else {
-            upwind = j - 1;
-            donor = j;
-            downwind = j + 1;
-            dif = upwind;
-          }
-          sigma = std::fabs(node_flux(i, j)) / (node_mass_pre(i, donor));
-          width = celldy[j];
-          vdiffuw = vel1(i, donor) - vel1(i, upwind);
-          vdiffdw = vel1(i, downwind) - vel1(i, donor);
-          limiter = 0.0;
-          if (vdiffuw * vdiffdw > 0.0) {
-            auw = std::fabs(vdiffuw);
-            adw = std::fabs(vdiffdw);
-            wind = 1.0;
-            if (vdiffdw <= 0.0) wind = -1.0;
-            limiter =
-                wind * std::fmin(std::fmin(width * ((2.0 - sigma) * adw / width + (1.0 + sigma) * auw / celldy[dif]) / 6.0, auw), adw);
-          }
-          advec_vel_s = vel1(i, donor) + (1.0 - sigma) * limiter;
-          mom_flux(i, j) = advec_vel_s * node_flux(i, j);
-        });
+      for (int j = (y_min - 1 + 1); j < (y_max + 1 + 2); j++) {
+        for (int i = (x_min + 1); i < (x_max + 1 + 2); i++)
+          ({
+            int upwind, donor, downwind, dif;
+            double sigma, width, limiter, vdiffuw, vdiffdw, auw, adw, wind, advec_vel_s;
+            if (node_flux(i, j) < 0.0) {
+              upwind = j + 2;
+              donor = j + 1;
+              downwind = j;
+              dif = donor;
+            } else {
+              upwind = j - 1;
+              donor = j;
+              downwind = j + 1;
+              dif = upwind;
+            }
+            sigma = std::fabs(node_flux(i, j)) / (node_mass_pre(i, donor));
+            width = celldy[j];
+            vdiffuw = vel1(i, donor) - vel1(i, upwind);
+            vdiffdw = vel1(i, downwind) - vel1(i, donor);
+            limiter = 0.0;
+            if (vdiffuw * vdiffdw > 0.0) {
+              auw = std::fabs(vdiffuw);
+              adw = std::fabs(vdiffdw);
+              wind = 1.0;
+              if (vdiffdw <= 0.0) wind = -1.0;
+              limiter =
+                  wind * std::fmin(std::fmin(width * ((2.0 - sigma) * adw / width + (1.0 + sigma) * auw / celldy[dif]) / 6.0, auw), adw);
+            }
+            advec_vel_s = vel1(i, donor) + (1.0 - sigma) * limiter;
+            mom_flux(i, j) = advec_vel_s * node_flux(i, j);
+          });
+      }
     }
 
     // DO k=y_min,y_max+1
@@ -234,11 +324,13 @@ void advec_mom_driver(global_variables &globals, int tile, int which_vel, int di
     advec_mom_kernel(t.info.t_xmin, t.info.t_xmax, t.info.t_ymin, t.info.t_ymax, t.field.xvel1, t.field.mass_flux_x, t.field.vol_flux_x,
                      t.field.mass_flux_y, t.field.vol_flux_y, t.field.volume, t.field.density1, t.field.work_array1, t.field.work_array2,
                      t.field.work_array3, t.field.work_array4, t.field.work_array5, t.field.work_array6, t.field.celldx, t.field.celldy,
-                     which_vel, sweep_number, direction);
+                     which_vel, sweep_number, direction, globals.advection_kernel == advection_kernel_type::simd,
+                     globals.stores == store_type::streaming);
   } else {
     advec_mom_kernel(t.info.t_xmin, t.info.t_xmax, t.info.t_ymin, t.info.t_ymax, t.field.yvel1, t.field.mass_flux_x, t.field.vol_flux_x,
                      t.field.mass_flux_y, t.field.vol_flux_y, t.field.volume, t.field.density1, t.field.work_array1, t.field.work_array2,
                      t.field.work_array3, t.field.work_array4, t.field.work_array5, t.field.work_array6, t.field.celldx, t.field.celldy,
-                     which_vel, sweep_number, direction);
+                     which_vel, sweep_number, direction, globals.advection_kernel == advection_kernel_type::simd,
+                     globals.stores == store_type::streaming);
   }
 }
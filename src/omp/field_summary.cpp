@@ -19,14 +19,16 @@
 
 #include "field_summary.h"
 #include "context.h"
-#include "ideal_gas.h"
+#include "dirty.h"
+#include "perf_counters.h"
 #include "report.h"
+#include "reproducible.h"
 #include "timer.h"
 
 #include <cmath>
 #include <iomanip>
 
-extern std::ostream g_out;
+extern thread_local std::ostream g_out;
 
 //  @brief Fortran field summary kernel
 //  @author Wayne Gaudin
@@ -47,11 +49,11 @@ void field_summary(global_variables &globals, parallel_ &parallel) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::ideal_gas);
 
-  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
-  }
+  clover::dirty::ideal_gas(globals);
 
+  clover::counters::end(clover::counters::ideal_gas);
   if (globals.profiler_on) {
     globals.profiler.ideal_gas += timer() - kernel_time;
     kernel_time = timer();
@@ -63,32 +65,41 @@ void field_summary(global_variables &globals, parallel_ &parallel) {
   double ke = 0.0;
   double press = 0.0;
 
-  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
-    tile_type &t = globals.chunk.tiles[tile];
-
-    int ymax = t.info.t_ymax;
-    int ymin = t.info.t_ymin;
-    int xmax = t.info.t_xmax;
-    int xmin = t.info.t_xmin;
-    field_type &field = t.field;
+  // Taken by reset_field already on this step with --fused-summary
+  if (clover::dirty::summary_current(globals)) {
+    vol = globals.fused.vol;
+    mass = globals.fused.mass;
+    ie = globals.fused.ie;
+    ke = globals.fused.ke;
+    press = globals.fused.press;
+  } else {
+    for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
+      tile_type &t = globals.chunk.tiles[tile];
+
+      int ymax = t.info.t_ymax;
+      int ymin = t.info.t_ymin;
+      int xmax = t.info.t_xmax;
+      int xmin = t.info.t_xmin;
+      field_type &field = t.field;
 
 #pragma omp parallel for simd reduction(+ : press) reduction(+ : ke) reduction(+ : ie) reduction(+ : mass) reduction(+ : vol)
-    for (int idx = (0); idx < ((ymax - ymin + 1) * (xmax - xmin + 1)); idx++) {
-      const int j = xmin + 1 + idx % (xmax - xmin + 1);
-      const int k = ymin + 1 + idx / (xmax - xmin + 1);
-      double vsqrd = 0.0;
-      for (int kv = k; kv <= k + 1; ++kv) {
-        for (int jv = j; jv <= j + 1; ++jv) {
-          vsqrd += 0.25 * (field.xvel0(jv, kv) * field.xvel0(jv, kv) + field.yvel0(jv, kv) * field.yvel0(jv, kv));
+      for (int idx = (0); idx < ((ymax - ymin + 1) * (xmax - xmin + 1)); idx++) {
+        const int j = xmin + 1 + idx % (xmax - xmin + 1);
+        const int k = ymin + 1 + idx / (xmax - xmin + 1);
+        double vsqrd = 0.0;
+        for (int kv = k; kv <= k + 1; ++kv) {
+          for (int jv = j; jv <= j + 1; ++jv) {
+            vsqrd += 0.25 * (field.xvel0(jv, kv) * field.xvel0(jv, kv) + field.yvel0(jv, kv) * field.yvel0(jv, kv));
+          }
         }
+        double cell_vol = field.volume(j, k);
+        double cell_mass = cell_vol * field.density0(j, k);
+        vol += cell_vol;
+        mass += cell_mass;
+        ie += cell_mass * field.energy0(j, k);
+        ke += cell_mass * 0.5 * vsqrd;
+        press += cell_vol * field.pressure(j, k);
       }
-      double cell_vol = field.volume(j, k);
-      double cell_mass = cell_vol * field.density0(j, k);
-      vol += cell_vol;
-      mass += cell_mass;
-      ie += cell_mass * field.energy0(j, k);
-      ke += cell_mass * 0.5 * vsqrd;
-      press += cell_vol * field.pressure(j, k);
     }
   }
 
@@ -97,6 +108,8 @@ void field_summary(global_variables &globals, parallel_ &parallel) {
   clover_sum(ie);
   clover_sum(ke);
   clover_sum(press);
+  // Order independent totals for --reproducible, in place of the ones above
+  if (globals.config.reproducible) clover::repro::field_summary(globals, vol, mass, ie, ke, press);
 
   if (globals.profiler_on) globals.profiler.summary += timer() - kernel_time;
 
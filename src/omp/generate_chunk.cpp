@@ -30,31 +30,8 @@
 
 void generate_chunk(const int tile, global_variables &globals) {
 
-  // Need to copy the host array of state input data into a device array
-  clover::Buffer1D<double> state_density(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_energy(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xvel(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_yvel(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xmin(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xmax(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_ymin(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_ymax(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_radius(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<int> state_geometry(globals.context, globals.config.number_of_states);
-
-  // Copy the data to the new views
-  for (int state = 0; state < globals.config.number_of_states; ++state) {
-    state_density[state] = globals.config.states[state].density;
-    state_energy[state] = globals.config.states[state].energy;
-    state_xvel[state] = globals.config.states[state].xvel;
-    state_yvel[state] = globals.config.states[state].yvel;
-    state_xmin[state] = globals.config.states[state].xmin;
-    state_xmax[state] = globals.config.states[state].xmax;
-    state_ymin[state] = globals.config.states[state].ymin;
-    state_ymax[state] = globals.config.states[state].ymax;
-    state_radius[state] = globals.config.states[state].radius;
-    state_geometry[state] = globals.config.states[state].geometry;
-  }
+  // The state table is read directly from the config, there is no device to copy it to
+  const std::vector<state_type> &states = globals.config.states;
 
   // Kokkos::deep_copy (TO, FROM)
 
@@ -74,53 +51,57 @@ void generate_chunk(const int tile, global_variables &globals) {
 #pragma omp parallel for simd collapse(2)
   for (int j = (0); j < (yrange); j++) {
     for (int i = (0); i < (xrange); i++) {
-      field.energy0(i, j) = state_energy[0];
-      field.density0(i, j) = state_density[0];
-      field.xvel0(i, j) = state_xvel[0];
-      field.yvel0(i, j) = state_yvel[0];
+      field.energy0(i, j) = states[0].energy;
+      field.density0(i, j) = states[0].density;
+      field.xvel0(i, j) = states[0].xvel;
+      field.yvel0(i, j) = states[0].yvel;
     }
   }
 
   for (int state = 1; state < globals.config.number_of_states; ++state) {
+    // Only sweep the cells this state can cover
+    const state_extent extent = generate_state_extent(globals, tile, states[state]);
+    if (extent.empty) continue;
+    const state_type s = states[state];
 #pragma omp parallel for simd collapse(2)
-    for (int j = (0); j < (yrange); j++) {
-      for (int i = (0); i < (xrange); i++) {
-        double x_cent = state_xmin[state];
-        double y_cent = state_ymin[state];
-        if (state_geometry[state] == g_rect) {
-          if (field.vertexx[i + 1] >= state_xmin[state] && field.vertexx[i] < state_xmax[state]) {
-            if (field.vertexy[j + 1] >= state_ymin[state] && field.vertexy[j] < state_ymax[state]) {
-              field.energy0(i, j) = state_energy[state];
-              field.density0(i, j) = state_density[state];
+    for (int j = extent.fromY; j < extent.toY; j++) {
+      for (int i = extent.fromX; i < extent.toX; i++) {
+        double x_cent = s.xmin;
+        double y_cent = s.ymin;
+        if (s.geometry == g_rect) {
+          if (field.vertexx[i + 1] >= s.xmin && field.vertexx[i] < s.xmax) {
+            if (field.vertexy[j + 1] >= s.ymin && field.vertexy[j] < s.ymax) {
+              field.energy0(i, j) = s.energy;
+              field.density0(i, j) = s.density;
               for (int kt = j; kt <= j + 1; ++kt) {
                 for (int jt = i; jt <= i + 1; ++jt) {
-                  field.xvel0(jt, kt) = state_xvel[state];
-                  field.yvel0(jt, kt) = state_yvel[state];
+                  field.xvel0(jt, kt) = s.xvel;
+                  field.yvel0(jt, kt) = s.yvel;
                 }
               }
             }
           }
-        } else if (state_geometry[state] == g_circ) {
+        } else if (s.geometry == g_circ) {
           double radius =
               std::sqrt((field.cellx[i] - x_cent) * (field.cellx[i] - x_cent) + (field.celly[j] - y_cent) * (field.celly[j] - y_cent));
-          if (radius <= state_radius[state]) {
-            field.energy0(i, j) = state_energy[state];
-            field.density0(i, j) = state_density[state];
+          if (radius <= s.radius) {
+            field.energy0(i, j) = s.energy;
+            field.density0(i, j) = s.density;
             for (int kt = j; kt <= j + 1; ++kt) {
               for (int jt = i; jt <= i + 1; ++jt) {
-                field.xvel0(jt, kt) = state_xvel[state];
-                field.yvel0(jt, kt) = state_yvel[state];
+                field.xvel0(jt, kt) = s.xvel;
+                field.yvel0(jt, kt) = s.yvel;
               }
             }
           }
-        } else if (state_geometry[state] == g_point) {
+        } else if (s.geometry == g_point) {
           if (field.vertexx[i] == x_cent && field.vertexy[j] == y_cent) {
-            field.energy0(i, j) = state_energy[state];
-            field.density0(i, j) = state_density[state];
+            field.energy0(i, j) = s.energy;
+            field.density0(i, j) = s.density;
             for (int kt = j; kt <= j + 1; ++kt) {
               for (int jt = i; jt <= i + 1; ++jt) {
-                field.xvel0(jt, kt) = state_xvel[state];
-                field.yvel0(jt, kt) = state_yvel[state];
+                field.xvel0(jt, kt) = s.xvel;
+                field.yvel0(jt, kt) = s.yvel;
               }
             }
           }
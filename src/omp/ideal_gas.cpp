@@ -19,14 +19,17 @@
 
 #include "ideal_gas.h"
 #include "context.h"
+#include "simd.h"
 #include <cmath>
 
+bool streaming_stores_supported() { return true; }
+
 //  @brief Fortran ideal gas kernel.
 //  @author Wayne Gaudin
 //  @details Calculates the pressure and sound speed for the mesh chunk using
 //  the ideal gas equation of state, with a fixed gamma of 1.4.
 void ideal_gas_kernel(int x_min, int x_max, int y_min, int y_max, clover::Buffer2D<double> &density, clover::Buffer2D<double> &energy,
-                      clover::Buffer2D<double> &pressure, clover::Buffer2D<double> &soundspeed) {
+                      clover::Buffer2D<double> &pressure, clover::Buffer2D<double> &soundspeed, bool streaming) {
 
   // std::cout <<" ideal_gas(" << x_min+1 << ","<< y_min+1<< ","<< x_max+2<< ","<< y_max +2  << ")" << std::endl;
   //  DO k=y_min,y_max
@@ -34,6 +37,21 @@ void ideal_gas_kernel(int x_min, int x_max, int y_min, int y_max, clover::Buffer
 
   //	Kokkos::MDRangePolicy <Kokkos::Rank<2>> policy({x_min + 1, y_min + 1}, {x_max + 2, y_max + 2});
 
+  if (streaming) {
+    // Same arithmetic, with the pressure kept in a register instead of read back from the streamed store
+    clover::simd::stream_rows(pressure.data, pressure.sizeX, x_min + 1, x_max + 2, y_min + 1, y_max + 2, [&](int i, int j, auto lane) {
+      using T = decltype(lane);
+      T d = clover::simd::load_as<T>(&density(i, j));
+      T v = 1.0 / d;
+      T p = (1.4 - 1.0) * d * clover::simd::load_as<T>(&energy(i, j));
+      T pressurebyenergy = (1.4 - 1.0) * d;
+      T pressurebyvolume = -d * p;
+      clover::simd::stream(&pressure(i, j), p);
+      clover::simd::stream(&soundspeed(i, j), clover::simd::sqrt(v * v * (p * pressurebyenergy - pressurebyvolume)));
+    });
+    return;
+  }
+
 #pragma omp parallel for simd collapse(2)
   for (int j = (y_min + 1); j < (y_max + 2); j++) {
     for (int i = (x_min + 1); i < (x_max + 2); i++) {
@@ -58,9 +76,9 @@ void ideal_gas(global_variables &globals, const int tile, bool predict) {
 
   if (!predict) {
     ideal_gas_kernel(t.info.t_xmin, t.info.t_xmax, t.info.t_ymin, t.info.t_ymax, t.field.density0, t.field.energy0, t.field.pressure,
-                     t.field.soundspeed);
+                     t.field.soundspeed, globals.stores == store_type::streaming);
   } else {
     ideal_gas_kernel(t.info.t_xmin, t.info.t_xmax, t.info.t_ymin, t.info.t_ymax, t.field.density1, t.field.energy1, t.field.pressure,
-                     t.field.soundspeed);
+                     t.field.soundspeed, globals.stores == store_type::streaming);
   }
 }
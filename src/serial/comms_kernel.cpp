@@ -33,12 +33,25 @@
 
 #include "comms_kernel.h"
 #include "comms.h"
+#include "comms_datatype.h"
+#include "comms_neighbour.h"
+#include "comms_shared.h"
 #include "pack_kernel.h"
 
 void clover_allocate_buffers(global_variables &globals, parallel_ &parallel) {
   // Unallocated buffers for external boundaries caused issues on some systems so they are now
   //  all allocated
   if (parallel.task == globals.chunk.task) {
+#ifndef NO_MPI
+    // --autotune may switch to any of the strategies between steps, so it needs all of them set up
+    bool tuning = !globals.config.autotune.empty();
+    if (globals.halo_exchange == halo_exchange_type::shared || tuning) {
+      globals.chunk.context.shared_halo = clover::halo::allocate_shared(globals);
+    }
+    if (globals.halo_exchange == halo_exchange_type::neighbour || tuning) {
+      globals.chunk.context.neighbour_halo = clover::halo::create_neighbour_graph(globals);
+    }
+#endif
     //    globals.chunk.context.left_snd = std::make_unique<clover::Buffer1D<double>>(globals.context, 10 * 2 * (globals.chunk.y_max + 5));
     //    globals.chunk.context.left_rcv = std::make_unique<clover::Buffer1D<double>>(globals.context, 10 * 2 * (globals.chunk.y_max + 5));
     //    globals.chunk.context.right_snd = std::make_unique<clover::Buffer1D<double>>(globals.context, 10 * 2 * (globals.chunk.y_max + 5));
@@ -51,8 +64,31 @@ void clover_allocate_buffers(global_variables &globals, parallel_ &parallel) {
   }
 }
 
+bool clover_exchange_supported(halo_exchange_type type) {
+#ifdef NO_MPI
+  return type == halo_exchange_type::pack;
+#else
+  return true;
+#endif
+}
+
 void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], const int depth) {
 
+#ifndef NO_MPI
+  if (globals.halo_exchange == halo_exchange_type::datatype) {
+    clover::halo::exchange(globals, fields, depth);
+    return;
+  }
+  if (globals.halo_exchange == halo_exchange_type::shared) {
+    clover::halo::exchange_shared(globals, *globals.chunk.context.shared_halo, fields, depth);
+    return;
+  }
+  if (globals.halo_exchange == halo_exchange_type::neighbour) {
+    clover::halo::exchange_neighbour(globals, *globals.chunk.context.neighbour_halo, fields, depth);
+    return;
+  }
+#endif
+
   // Assuming 1 patch per task, this will be changed
 
   int left_right_offset[NUM_FIELDS];
@@ -72,15 +108,16 @@ void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], co
     }
   }
 
-  static clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
+  // Ranks may be threads of one process (see mpi_shim.h), so every thread keeps its own buffers
+  static thread_local clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
 
-  static clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
 
   if (globals.chunk.chunk_neighbours[chunk_left] != external_face) {
     // do left exchanges
@@ -196,11 +233,11 @@ void clover_send_recv_message_left(global_variables &globals, clover::Buffer1D<d
   // First copy send buffer from device to host
   //	Kokkos::deep_copy(globals.chunk.hm_left_snd, left_snd);
 
-  int left_task = globals.chunk.chunk_neighbours[chunk_left] - 1;
+  int left_task = globals.chunk.neighbour_task(chunk_left);
 
-  MPI_Isend(left_snd.actual(), total_size, MPI_DOUBLE, left_task, tag_send, MPI_COMM_WORLD, &req_send);
+  MPI_Isend(left_snd.actual(), total_size, MPI_DOUBLE, left_task, tag_send, g_comm, &req_send);
 
-  MPI_Irecv(left_rcv.actual(), total_size, MPI_DOUBLE, left_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  MPI_Irecv(left_rcv.actual(), total_size, MPI_DOUBLE, left_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_right(global_variables &globals, clover::Buffer1D<double> &right_snd, clover::Buffer1D<double> &right_rcv,
                                     int total_size, int tag_send, int tag_recv, MPI_Request &req_send, MPI_Request &req_recv) {
@@ -208,11 +245,11 @@ void clover_send_recv_message_right(global_variables &globals, clover::Buffer1D<
   // First copy send buffer from device to host
   //	Kokkos::deep_copy(globals.chunk.hm_right_snd, right_snd);
 
-  int right_task = globals.chunk.chunk_neighbours[chunk_right] - 1;
+  int right_task = globals.chunk.neighbour_task(chunk_right);
 
-  MPI_Isend(right_snd.actual(), total_size, MPI_DOUBLE, right_task, tag_send, MPI_COMM_WORLD, &req_send);
+  MPI_Isend(right_snd.actual(), total_size, MPI_DOUBLE, right_task, tag_send, g_comm, &req_send);
 
-  MPI_Irecv(right_rcv.actual(), total_size, MPI_DOUBLE, right_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  MPI_Irecv(right_rcv.actual(), total_size, MPI_DOUBLE, right_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_top(global_variables &globals, clover::Buffer1D<double> &top_snd, clover::Buffer1D<double> &top_rcv,
                                   int total_size, int tag_send, int tag_recv, MPI_Request &req_send, MPI_Request &req_recv) {
@@ -220,11 +257,11 @@ void clover_send_recv_message_top(global_variables &globals, clover::Buffer1D<do
   // First copy send buffer from device to host
   //	Kokkos::deep_copy(globals.chunk.hm_top_snd, top_snd);
 
-  int top_task = globals.chunk.chunk_neighbours[chunk_top] - 1;
+  int top_task = globals.chunk.neighbour_task(chunk_top);
 
-  MPI_Isend(top_snd.actual(), total_size, MPI_DOUBLE, top_task, tag_send, MPI_COMM_WORLD, &req_send);
+  MPI_Isend(top_snd.actual(), total_size, MPI_DOUBLE, top_task, tag_send, g_comm, &req_send);
 
-  MPI_Irecv(top_rcv.actual(), total_size, MPI_DOUBLE, top_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  MPI_Irecv(top_rcv.actual(), total_size, MPI_DOUBLE, top_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_bottom(global_variables &globals, clover::Buffer1D<double> &bottom_snd, clover::Buffer1D<double> &bottom_rcv,
                                      int total_size, int tag_send, int tag_recv, MPI_Request &req_send, MPI_Request &req_recv) {
@@ -232,9 +269,9 @@ void clover_send_recv_message_bottom(global_variables &globals, clover::Buffer1D
   // First copy send buffer from device to host
   //	Kokkos::deep_copy(globals.chunk.hm_bottom_snd, bottom_snd);
 
-  int bottom_task = globals.chunk.chunk_neighbours[chunk_bottom] - 1;
+  int bottom_task = globals.chunk.neighbour_task(chunk_bottom);
 
-  MPI_Isend(bottom_snd.actual(), total_size, MPI_DOUBLE, bottom_task, tag_send, MPI_COMM_WORLD, &req_send);
+  MPI_Isend(bottom_snd.actual(), total_size, MPI_DOUBLE, bottom_task, tag_send, g_comm, &req_send);
 
-  MPI_Irecv(bottom_rcv.actual(), total_size, MPI_DOUBLE, bottom_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  MPI_Irecv(bottom_rcv.actual(), total_size, MPI_DOUBLE, bottom_task, tag_recv, g_comm, &req_recv);
 }
@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "huge_pages.h"
 #include "shared.h"
 
 #define SYCL_DEBUG   // enable for debugging SYCL related things, also syncs kernel calls
@@ -33,15 +34,20 @@ namespace clover {
 
 struct context {};
 
-template <typename T> static inline T *alloc(size_t count) { return static_cast<T *>(std::malloc(count * sizeof(T))); }
+// Huge page backed when --huge-pages asks for it, see huge_pages.h
+template <typename T> static inline T *alloc(size_t count) { return static_cast<T *>(clover::pages::allocate(count * sizeof(T))); }
 
 template <typename T> struct Buffer1D {
   size_t size;
   T *data;
+  bool owned = true; // False over storage carved from a tile's arena, see arena.h
   Buffer1D(context &, size_t size) : size(size), data(alloc<T>(size)) {}
-  Buffer1D(Buffer1D &&other) noexcept : size(other.size), data(std::exchange(other.data, nullptr)) {}
-  Buffer1D(const Buffer1D<T> &that) : size(that.size), data(that.data) {}
-  ~Buffer1D() { std::free(data); }
+  Buffer1D(context &, size_t size, T *storage) : size(size), data(storage), owned(false) {}
+  Buffer1D(Buffer1D &&other) noexcept : size(other.size), data(std::exchange(other.data, nullptr)), owned(other.owned) {}
+  Buffer1D(const Buffer1D<T> &that) : size(that.size), data(that.data), owned(that.owned) {}
+  ~Buffer1D() {
+    if (owned) clover::pages::release(data);
+  }
 
   T &operator[](size_t i) const { return data[i]; }
   T *actual() { return data; }
@@ -61,10 +67,15 @@ template <typename T> struct Buffer1D {
 template <typename T> struct Buffer2D {
   size_t sizeX, sizeY;
   T *data;
+  bool owned = true; // False over storage carved from a tile's arena, see arena.h
   Buffer2D(context &, size_t sizeX, size_t sizeY) : sizeX(sizeX), sizeY(sizeY), data(alloc<T>(sizeX * sizeY)) {}
-  Buffer2D(Buffer2D &&other) noexcept : sizeX(other.sizeX), sizeY(other.sizeY), data(std::exchange(other.data, nullptr)) {}
-  Buffer2D(const Buffer2D<T> &that) : sizeX(that.sizeX), sizeY(that.sizeY), data(that.data) {}
-  ~Buffer2D() { std::free(data); }
+  Buffer2D(context &, size_t sizeX, size_t sizeY, T *storage) : sizeX(sizeX), sizeY(sizeY), data(storage), owned(false) {}
+  Buffer2D(Buffer2D &&other) noexcept
+      : sizeX(other.sizeX), sizeY(other.sizeY), data(std::exchange(other.data, nullptr)), owned(other.owned) {}
+  Buffer2D(const Buffer2D<T> &that) : sizeX(that.sizeX), sizeY(that.sizeY), data(that.data), owned(that.owned) {}
+  ~Buffer2D() {
+    if (owned) clover::pages::release(data);
+  }
 
   T &operator()(size_t i, size_t j) const { return data[j + i * sizeY]; }
   T *actual() { return data; }
@@ -89,7 +100,17 @@ template <typename T> struct Buffer2D {
 };
 template <typename T> using StagingBuffer1D = Buffer1D<T> &;
 
-struct chunk_context {};
+namespace halo {
+struct shared_window;
+struct neighbour_graph;
+} // namespace halo
+
+struct chunk_context {
+  // Node-shared halo window, only allocated for --halo-exchange shared (see comms_shared.h)
+  std::shared_ptr<halo::shared_window> shared_halo;
+  // Neighbourhood communicator, only created for --halo-exchange neighbour (see comms_neighbour.h)
+  std::shared_ptr<halo::neighbour_graph> neighbour_halo;
+};
 
 } // namespace clover
 
@@ -0,0 +1,30 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "field_view.h"
+
+// Fields are host memory with y as the fastest index
+clover::field_view clover_field_view(global_variables &globals, int tile, int field) {
+  auto *buffer = clover::field_buffer(globals.chunk.tiles[tile].field, field);
+  if (!buffer) return {nullptr, 0, 0, 0, 0, clover::field_view::memory::none};
+  return {buffer->data, buffer->sizeX, buffer->sizeY, static_cast<std::ptrdiff_t>(buffer->sizeY), 1, clover::field_view::memory::host};
+}
+
+// Host memory, the buffer is the current copy
+std::vector<double> clover_field_host(global_variables &, clover::Buffer2D<double> &buffer) { return buffer.mirrored(); }
@@ -21,6 +21,8 @@
 #include "context.h"
 #include <cmath>
 
+bool streaming_stores_supported() { return false; }
+
 //  @brief Fortran ideal gas kernel.
 //  @author Wayne Gaudin
 //  @details Calculates the pressure and sound speed for the mesh chunk using
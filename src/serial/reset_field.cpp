@@ -19,8 +19,13 @@
 
 #include "reset_field.h"
 #include "context.h"
+#include "perf_counters.h"
 #include "timer.h"
 
+#include <cmath>
+
+bool fused_summary_supported() { return true; }
+
 //  @brief Fortran reset field kernel.
 //  @author Wayne Gaudin
 //  @details Copies all of the final end of step filed data to the begining of
@@ -50,6 +55,73 @@ void reset_field_kernel(int x_min, int x_max, int y_min, int y_max, clover::Buff
   }
 }
 
+//  @brief Reset field kernel fused with the ideal gas update and the field summary.
+//  @details Copies the cell fields like reset_field_kernel, runs the ideal gas
+//  kernel on the copies and adds up the field summary of the new level 0 fields
+//  while they are still in registers. The velocities are read from level 1, as
+//  the level 0 ones are only copied afterwards. The loop and its reduction are
+//  shaped like the field summary's, so the sums come out the same.
+void reset_field_summary_kernel(int x_min, int x_max, int y_min, int y_max, clover::Buffer2D<double> &density0,
+                                clover::Buffer2D<double> &density1, clover::Buffer2D<double> &energy0, clover::Buffer2D<double> &energy1,
+                                clover::Buffer2D<double> &pressure, clover::Buffer2D<double> &soundspeed, clover::Buffer2D<double> &xvel0,
+                                clover::Buffer2D<double> &xvel1, clover::Buffer2D<double> &yvel0, clover::Buffer2D<double> &yvel1,
+                                clover::Buffer2D<double> &volume, fused_summary_type &sums) {
+
+  double vol = sums.vol;
+  double mass = sums.mass;
+  double ie = sums.ie;
+  double ke = sums.ke;
+  double press = sums.press;
+
+  /* kernel region */
+  for (int idx = (0); idx < ((y_max - y_min + 1) * (x_max - x_min + 1)); idx++) {
+    const int j = x_min + 1 + idx % (x_max - x_min + 1);
+    const int k = y_min + 1 + idx / (x_max - x_min + 1);
+    const double density = density1(j, k);
+    const double energy = energy1(j, k);
+    density0(j, k) = density;
+    energy0(j, k) = energy;
+
+    double v = 1.0 / density;
+    const double cell_pressure = (1.4 - 1.0) * density * energy;
+    pressure(j, k) = cell_pressure;
+    double pressurebyenergy = (1.4 - 1.0) * density;
+    double pressurebyvolume = -density * cell_pressure;
+    double sound_speed_squared = v * v * (cell_pressure * pressurebyenergy - pressurebyvolume);
+    soundspeed(j, k) = std::sqrt(sound_speed_squared);
+
+    double vsqrd = 0.0;
+    for (int kv = k; kv <= k + 1; ++kv) {
+      for (int jv = j; jv <= j + 1; ++jv) {
+        vsqrd += 0.25 * (xvel1(jv, kv) * xvel1(jv, kv) + yvel1(jv, kv) * yvel1(jv, kv));
+      }
+    }
+    double cell_vol = volume(j, k);
+    double cell_mass = cell_vol * density;
+    vol += cell_vol;
+    mass += cell_mass;
+    ie += cell_mass * energy;
+    ke += cell_mass * 0.5 * vsqrd;
+    press += cell_vol * cell_pressure;
+  }
+
+  sums.vol = vol;
+  sums.mass = mass;
+  sums.ie = ie;
+  sums.ke = ke;
+  sums.press = press;
+
+  // DO k=y_min,y_max+1
+  //   DO j=x_min,x_max+1
+  /* kernel region */
+  for (int j = (y_min + 1); j < (y_max + 1 + 2); j++) {
+    for (int i = (x_min + 1); i < (x_max + 1 + 2); i++) {
+      xvel0(i, j) = xvel1(i, j);
+      yvel0(i, j) = yvel1(i, j);
+    }
+  }
+}
+
 //  @brief Reset field driver
 //  @author Wayne Gaudin
 //  @details Invokes the user specified field reset kernel.
@@ -57,6 +129,20 @@ void reset_field(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::reset_field);
+
+  if (globals.fused.due) {
+    globals.fused = {false, true, 0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
+      tile_type &t = globals.chunk.tiles[tile];
+      reset_field_summary_kernel(t.info.t_xmin, t.info.t_xmax, t.info.t_ymin, t.info.t_ymax, t.field.density0, t.field.density1,
+                                 t.field.energy0, t.field.energy1, t.field.pressure, t.field.soundspeed, t.field.xvel0, t.field.xvel1,
+                                 t.field.yvel0, t.field.yvel1, t.field.volume, globals.fused);
+    }
+    clover::counters::end(clover::counters::reset_field);
+    if (globals.profiler_on) globals.profiler.reset += timer() - kernel_time;
+    return;
+  }
 
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
 
@@ -67,5 +153,6 @@ void reset_field(global_variables &globals) {
                        t.field.yvel1);
   }
 
+  clover::counters::end(clover::counters::reset_field);
   if (globals.profiler_on) globals.profiler.reset += timer() - kernel_time;
 }
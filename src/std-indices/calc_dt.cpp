@@ -44,19 +44,11 @@ void calc_dt_kernel(int x_min, int x_max, int y_min, int y_max, double dtmin, do
   //   DO j=x_min,x_max
   //	Kokkos::MDRangePolicy <Kokkos::Rank<2>> policy({x_min + 1, y_min + 1}, {x_max + 2, y_max + 2});
 
-  int xStart = x_min + 1, xEnd = x_max + 2;
-  int yStart = y_min + 1, yEnd = y_max + 2;
-  int sizeX = xEnd - xStart;
   // y = y_min + 1  |  y_max + 2
 
-  auto r = clover::range<int>(0, (xEnd - xStart) * (yEnd - yStart));
-
-  dt_min_val = std::transform_reduce(
-      EXEC_POLICY, r.begin(), r.end(), g_big, [](auto l, auto r) { return std::fmin(l, r); },
-      [=](int v) {
-        const auto i = xStart + (v % sizeX);
-        const auto j = yStart + (v / sizeX);
-
+  dt_min_val = clover::par_reduce2(
+      Range2d{x_min + 1, y_min + 1, x_max + 2, y_max + 2}, g_big, [](auto l, auto r) { return std::fmin(l, r); },
+      [=](const int i, const int j) {
         double dsx = celldx[i];
         double dsy = celldy[j];
 
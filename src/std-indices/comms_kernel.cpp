@@ -33,6 +33,9 @@
 
 #include "comms_kernel.h"
 #include "comms.h"
+#include "comms_datatype.h"
+#include "comms_neighbour.h"
+#include "comms_shared.h"
 #include "pack_kernel.h"
 
 void clover_allocate_buffers(global_variables &globals, parallel_ &parallel) {
@@ -40,6 +43,16 @@ void clover_allocate_buffers(global_variables &globals, parallel_ &parallel) {
   // Unallocated buffers for external boundaries caused issues on some systems so they are now
   //  all allocated
   if (parallel.task == globals.chunk.task) {
+#ifndef NO_MPI
+    // --autotune may switch to any of the strategies between steps, so it needs all of them set up
+    bool tuning = !globals.config.autotune.empty();
+    if (globals.halo_exchange == halo_exchange_type::shared || tuning) {
+      globals.chunk.context.shared_halo = clover::halo::allocate_shared(globals);
+    }
+    if (globals.halo_exchange == halo_exchange_type::neighbour || tuning) {
+      globals.chunk.context.neighbour_halo = clover::halo::create_neighbour_graph(globals);
+    }
+#endif
 
     //		new(&globals.chunk.left_snd)   Kokkos::View<double *>("left_snd", 10 * 2 * (globals.chunk.y_max +	5));
     //		new(&globals.chunk.left_rcv)   Kokkos::View<double *>("left_rcv", 10 * 2 * (globals.chunk.y_max +	5));
@@ -68,8 +81,31 @@ void clover_allocate_buffers(global_variables &globals, parallel_ &parallel) {
   }
 }
 
+bool clover_exchange_supported(halo_exchange_type type) {
+#ifdef NO_MPI
+  return type == halo_exchange_type::pack;
+#else
+  return true;
+#endif
+}
+
 void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], const int depth) {
 
+#ifndef NO_MPI
+  if (globals.halo_exchange == halo_exchange_type::datatype) {
+    clover::halo::exchange(globals, fields, depth);
+    return;
+  }
+  if (globals.halo_exchange == halo_exchange_type::shared) {
+    clover::halo::exchange_shared(globals, *globals.chunk.context.shared_halo, fields, depth);
+    return;
+  }
+  if (globals.halo_exchange == halo_exchange_type::neighbour) {
+    clover::halo::exchange_neighbour(globals, *globals.chunk.context.neighbour_halo, fields, depth);
+    return;
+  }
+#endif
+
   // Assuming 1 patch per task, this will be changed
 
   int left_right_offset[NUM_FIELDS];
@@ -89,15 +125,16 @@ void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], co
     }
   }
 
-  static clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
+  // Ranks may be threads of one process (see mpi_shim.h), so every thread keeps its own buffers
+  static thread_local clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
 
-  static clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
 
   if (globals.chunk.chunk_neighbours[chunk_left] != external_face) {
     // do left exchanges
@@ -211,28 +248,28 @@ void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], co
 void clover_send_recv_message_left(global_variables &globals, clover::Buffer1D<double> &left_snd_buffer,
                                    clover::Buffer1D<double> &left_rcv_buffer, int total_size, int tag_send, int tag_recv,
                                    MPI_Request &req_send, MPI_Request &req_recv) {
-  int left_task = globals.chunk.chunk_neighbours[chunk_left] - 1;
-  MPI_Isend(left_snd_buffer.data, total_size, MPI_DOUBLE, left_task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(left_rcv_buffer.data, total_size, MPI_DOUBLE, left_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int left_task = globals.chunk.neighbour_task(chunk_left);
+  MPI_Isend(left_snd_buffer.data, total_size, MPI_DOUBLE, left_task, tag_send, g_comm, &req_send);
+  MPI_Irecv(left_rcv_buffer.data, total_size, MPI_DOUBLE, left_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_right(global_variables &globals, clover::Buffer1D<double> &right_snd_buffer,
                                     clover::Buffer1D<double> &right_rcv_buffer, int total_size, int tag_send, int tag_recv,
                                     MPI_Request &req_send, MPI_Request &req_recv) {
-  int right_task = globals.chunk.chunk_neighbours[chunk_right] - 1;
-  MPI_Isend(right_snd_buffer.data, total_size, MPI_DOUBLE, right_task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(right_rcv_buffer.data, total_size, MPI_DOUBLE, right_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int right_task = globals.chunk.neighbour_task(chunk_right);
+  MPI_Isend(right_snd_buffer.data, total_size, MPI_DOUBLE, right_task, tag_send, g_comm, &req_send);
+  MPI_Irecv(right_rcv_buffer.data, total_size, MPI_DOUBLE, right_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_top(global_variables &globals, clover::Buffer1D<double> &top_snd_buffer,
                                   clover::Buffer1D<double> &top_rcv_buffer, int total_size, int tag_send, int tag_recv,
                                   MPI_Request &req_send, MPI_Request &req_recv) {
-  int top_task = globals.chunk.chunk_neighbours[chunk_top] - 1;
-  MPI_Isend(top_snd_buffer.data, total_size, MPI_DOUBLE, top_task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(top_rcv_buffer.data, total_size, MPI_DOUBLE, top_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int top_task = globals.chunk.neighbour_task(chunk_top);
+  MPI_Isend(top_snd_buffer.data, total_size, MPI_DOUBLE, top_task, tag_send, g_comm, &req_send);
+  MPI_Irecv(top_rcv_buffer.data, total_size, MPI_DOUBLE, top_task, tag_recv, g_comm, &req_recv);
 }
 void clover_send_recv_message_bottom(global_variables &globals, clover::Buffer1D<double> &bottom_snd_buffer,
                                      clover::Buffer1D<double> &bottom_rcv_buffer, int total_size, int tag_send, int tag_recv,
                                      MPI_Request &req_send, MPI_Request &req_recv) {
-  int bottom_task = globals.chunk.chunk_neighbours[chunk_bottom] - 1;
-  MPI_Isend(bottom_snd_buffer.data, total_size, MPI_DOUBLE, bottom_task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(bottom_rcv_buffer.data, total_size, MPI_DOUBLE, bottom_task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int bottom_task = globals.chunk.neighbour_task(chunk_bottom);
+  MPI_Isend(bottom_snd_buffer.data, total_size, MPI_DOUBLE, bottom_task, tag_send, g_comm, &req_send);
+  MPI_Irecv(bottom_rcv_buffer.data, total_size, MPI_DOUBLE, bottom_task, tag_recv, g_comm, &req_recv);
 }
@@ -30,7 +30,17 @@
 
 namespace clover {
 
-struct chunk_context {};
+namespace halo {
+struct shared_window;
+struct neighbour_graph;
+} // namespace halo
+
+struct chunk_context {
+  // Node-shared halo window, only allocated for --halo-exchange shared (see comms_shared.h)
+  std::shared_ptr<halo::shared_window> shared_halo;
+  // Neighbourhood communicator, only created for --halo-exchange neighbour (see comms_neighbour.h)
+  std::shared_ptr<halo::neighbour_graph> neighbour_halo;
+};
 struct context {};
 
 template <typename T> struct Buffer1D {
@@ -171,13 +181,56 @@ template <typename F> static void par_ranged1(const Range1d &r, const F &functor
   // }
 }
 
+#define RANGE2D_LINEAR 0x02
+#define RANGE2D_BLOCKED 0x08
+
+#ifndef RANGE2D_MODE
+  #if defined(USE_ONEDPL) && ONEDPL_USE_DPCPP_BACKEND
+    #define RANGE2D_MODE RANGE2D_LINEAR
+  #else
+    #define RANGE2D_MODE RANGE2D_BLOCKED
+  #endif
+#endif
+
+#ifndef RANGE2D_BLOCK_X
+  #define RANGE2D_BLOCK_X 256
+#endif
+
+// Number of parallel work items for a Range2d: one per cell when linearised, otherwise one per row segment of up to
+// RANGE2D_BLOCK_X cells. Blocking keeps the inner x loop unit-stride (and vectorisable) and amortises the div/mod
+// needed to recover the row and segment from the work item index over a whole segment instead of paying it per cell.
+static inline size_t range2d_blocks_x(const Range2d &r) {
+#if RANGE2D_MODE == RANGE2D_LINEAR
+  return r.sizeX;
+#elif RANGE2D_MODE == RANGE2D_BLOCKED
+  return (r.sizeX + RANGE2D_BLOCK_X - 1) / RANGE2D_BLOCK_X;
+#else
+  #error "Unsupported RANGE2D_MODE"
+#endif
+}
+
 template <typename F> static void par_ranged2(const Range2d &r, const F &functor) {
+#if RANGE2D_MODE == RANGE2D_LINEAR
   auto xy = range<int>(0, r.sizeX * r.sizeY);
   std::for_each(EXEC_POLICY, xy.begin(), xy.end(), [=](int v) {
     const auto x = r.fromX + (v % r.sizeX);
     const auto y = r.fromY + (v / r.sizeX);
     functor(x, y);
   });
+#elif RANGE2D_MODE == RANGE2D_BLOCKED
+  const size_t blocksX = range2d_blocks_x(r);
+  auto blocks = range<int>(0, blocksX * r.sizeY);
+  std::for_each(EXEC_POLICY, blocks.begin(), blocks.end(), [=](int b) {
+    const size_t y = r.fromY + (b / blocksX);
+    const size_t xStart = r.fromX + (b % blocksX) * RANGE2D_BLOCK_X;
+    const size_t xEnd = std::min(xStart + RANGE2D_BLOCK_X, r.toX);
+    for (size_t x = xStart; x < xEnd; x++) {
+      functor(x, y);
+    }
+  });
+#else
+  #error "Unsupported RANGE2D_MODE"
+#endif
   // for (size_t j = r.fromY; j < r.toY; j++) {
   //     for (size_t i = r.fromX; i < r.toX; i++) {
   //         functor(i, j);
@@ -185,6 +238,34 @@ template <typename F> static void par_ranged2(const Range2d &r, const F &functor
   // }
 }
 
+// transform_reduce over a Range2d using the same work item decomposition as par_ranged2, each block is reduced serially
+// before being combined with `op`
+template <typename T, typename Op, typename F> static T par_reduce2(const Range2d &r, T init, const Op &op, const F &functor) {
+#if RANGE2D_MODE == RANGE2D_LINEAR
+  auto xy = range<int>(0, r.sizeX * r.sizeY);
+  return std::transform_reduce(EXEC_POLICY, xy.begin(), xy.end(), init, op, [=](int v) {
+    const auto x = r.fromX + (v % r.sizeX);
+    const auto y = r.fromY + (v / r.sizeX);
+    return functor(x, y);
+  });
+#elif RANGE2D_MODE == RANGE2D_BLOCKED
+  const size_t blocksX = range2d_blocks_x(r);
+  auto blocks = range<int>(0, blocksX * r.sizeY);
+  return std::transform_reduce(EXEC_POLICY, blocks.begin(), blocks.end(), init, op, [=](int b) {
+    const size_t y = r.fromY + (b / blocksX);
+    const size_t xStart = r.fromX + (b % blocksX) * RANGE2D_BLOCK_X;
+    const size_t xEnd = std::min(xStart + RANGE2D_BLOCK_X, r.toX);
+    T acc = functor(xStart, y);
+    for (size_t x = xStart + 1; x < xEnd; x++) {
+      acc = op(acc, functor(x, y));
+    }
+    return acc;
+  });
+#else
+  #error "Unsupported RANGE2D_MODE"
+#endif
+}
+
 } // namespace clover
 
 using clover::Range1d;
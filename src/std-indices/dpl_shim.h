@@ -67,7 +67,10 @@ static constexpr auto EXEC_POLICY = std::execution::par_unseq;
 
 #ifdef USE_STD_PTR_ALLOC_DEALLOC
 
-template <typename T> T *alloc_raw(size_t size) { return static_cast<T *>(std::malloc(size * sizeof(T))); }
-template <typename T> void dealloc_raw(T *ptr) { std::free(ptr); }
+  #include "huge_pages.h"
+
+// Huge page backed when --huge-pages asks for it, see huge_pages.h
+template <typename T> T *alloc_raw(size_t size) { return static_cast<T *>(clover::pages::allocate(size * sizeof(T))); }
+template <typename T> void dealloc_raw(T *ptr) { clover::pages::release(ptr); }
 
 #endif
@@ -19,8 +19,10 @@
 
 #include "field_summary.h"
 #include "context.h"
-#include "ideal_gas.h"
+#include "dirty.h"
+#include "perf_counters.h"
 #include "report.h"
+#include "reproducible.h"
 #include "timer.h"
 
 #include <iomanip>
@@ -44,11 +46,11 @@ void field_summary(global_variables &globals, parallel_ &parallel) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::ideal_gas);
 
-  for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
-    ideal_gas(globals, tile, false);
-  }
+  clover::dirty::ideal_gas(globals);
 
+  clover::counters::end(clover::counters::ideal_gas);
   if (globals.profiler_on) {
     globals.profiler.ideal_gas += timer() - kernel_time;
     kernel_time = timer();
@@ -78,10 +80,7 @@ void field_summary(global_variables &globals, parallel_ &parallel) {
     int xmin = t.info.t_xmin;
     field_type &field = t.field;
 
-    auto r = clover::range<size_t>(0, (ymax - ymin + 1) * (xmax - xmin + 1));
-    s = std::transform_reduce(EXEC_POLICY, r.begin(), r.end(), s, std::plus<>(), [=](size_t idx) {
-      const size_t j = xmin + 1 + idx % (xmax - xmin + 1);
-      const size_t k = ymin + 1 + idx / (xmax - xmin + 1);
+    s = clover::par_reduce2(Range2d{xmin + 1, ymin + 1, xmax + 2, ymax + 2}, s, std::plus<>(), [=](const size_t j, const size_t k) {
       double vsqrd = 0.0;
       for (size_t kv = k; kv <= k + 1; ++kv) {
         for (size_t jv = j; jv <= j + 1; ++jv) {
@@ -105,8 +104,10 @@ void field_summary(global_variables &globals, parallel_ &parallel) {
   clover_sum(ie);
   clover_sum(ke);
   clover_sum(press);
+  // Order independent totals for --reproducible, in place of the ones above
+  if (globals.config.reproducible) clover::repro::field_summary(globals, vol, mass, ie, ke, press);
 
   if (globals.profiler_on) globals.profiler.summary += timer() - kernel_time;
 
-  clover_report_step(globals, parallel, vol, mass, ie, ke, mass);
+  clover_report_step(globals, parallel, vol, mass, ie, ke, press);
 }
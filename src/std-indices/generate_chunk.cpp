@@ -30,31 +30,8 @@
 
 void generate_chunk(const int tile, global_variables &globals) {
 
-  // Need to copy the host array of state input data into a device array
-  clover::Buffer1D<double> state_density(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_energy(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xvel(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_yvel(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xmin(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_xmax(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_ymin(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_ymax(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<double> state_radius(globals.context, globals.config.number_of_states);
-  clover::Buffer1D<int> state_geometry(globals.context, globals.config.number_of_states);
-
-  // Copy the data to the new views
-  for (int state = 0; state < globals.config.number_of_states; ++state) {
-    state_density[state] = globals.config.states[state].density;
-    state_energy[state] = globals.config.states[state].energy;
-    state_xvel[state] = globals.config.states[state].xvel;
-    state_yvel[state] = globals.config.states[state].yvel;
-    state_xmin[state] = globals.config.states[state].xmin;
-    state_xmax[state] = globals.config.states[state].xmax;
-    state_ymin[state] = globals.config.states[state].ymin;
-    state_ymax[state] = globals.config.states[state].ymax;
-    state_radius[state] = globals.config.states[state].radius;
-    state_geometry[state] = globals.config.states[state].geometry;
-  }
+  // States are captured by value, so no temporary state table has to be allocated
+  const std::vector<state_type> &states = globals.config.states;
 
   // Kokkos::deep_copy (TO, FROM)
 
@@ -74,76 +51,64 @@ void generate_chunk(const int tile, global_variables &globals) {
 
   // State 1 is always the background state
 
-  clover::par_ranged2(xyrange_policy, [=, state_energy = state_energy.actual(), state_density = state_density.actual(),
-                                       state_xvel = state_xvel.actual(), state_yvel = state_yvel.actual()](const size_t i, const size_t j) {
-    field.energy0(i, j) = state_energy[0];
-    field.density0(i, j) = state_density[0];
-    field.xvel0(i, j) = state_xvel[0];
-    field.yvel0(i, j) = state_yvel[0];
+  clover::par_ranged2(xyrange_policy, [=, s = states[0]](const size_t i, const size_t j) {
+    field.energy0(i, j) = s.energy;
+    field.density0(i, j) = s.density;
+    field.xvel0(i, j) = s.xvel;
+    field.yvel0(i, j) = s.yvel;
   });
 
   for (int state = 1; state < globals.config.number_of_states; ++state) {
+    // Only sweep the cells this state can cover
+    const state_extent extent = generate_state_extent(globals, tile, states[state]);
+    if (extent.empty) continue;
 
     clover::par_ranged2(
-        xyrange_policy, [=, state_density = state_density.actual(), state_energy = state_energy.actual(), state_xvel = state_xvel.actual(),
-                         state_yvel = state_yvel.actual(), state_xmin = state_xmin.actual(), state_xmax = state_xmax.actual(),
-                         state_ymin = state_ymin.actual(), state_ymax = state_ymax.actual(), state_radius = state_radius.actual(),
-                         state_geometry = state_geometry.actual()](const size_t x, const size_t y) {
+        Range2d{extent.fromX, extent.fromY, extent.toX, extent.toY}, [=, s = states[state]](const size_t x, const size_t y) {
           const int j = x;
           const int k = y;
 
-          double x_cent = state_xmin[state];
-          double y_cent = state_ymin[state];
+          double x_cent = s.xmin;
+          double y_cent = s.ymin;
 
-          if (state_geometry[state] == g_rect) {
-            if (field.vertexx[j + 1] >= state_xmin[state] && field.vertexx[j] < state_xmax[state]) {
-              if (field.vertexy[k + 1] >= state_ymin[state] && field.vertexy[k] < state_ymax[state]) {
-                field.energy0(x, y) = state_energy[state];
-                field.density0(x, y) = state_density[state];
+          if (s.geometry == g_rect) {
+            if (field.vertexx[j + 1] >= s.xmin && field.vertexx[j] < s.xmax) {
+              if (field.vertexy[k + 1] >= s.ymin && field.vertexy[k] < s.ymax) {
+                field.energy0(x, y) = s.energy;
+                field.density0(x, y) = s.density;
                 for (int kt = k; kt <= k + 1; ++kt) {
                   for (int jt = j; jt <= j + 1; ++jt) {
-                    field.xvel0(jt, kt) = state_xvel[state];
-                    field.yvel0(jt, kt) = state_yvel[state];
+                    field.xvel0(jt, kt) = s.xvel;
+                    field.yvel0(jt, kt) = s.yvel;
                   }
                 }
               }
             }
-          } else if (state_geometry[state] == g_circ) {
+          } else if (s.geometry == g_circ) {
             double radius =
                 std::sqrt((field.cellx[j] - x_cent) * (field.cellx[j] - x_cent) + (field.celly[k] - y_cent) * (field.celly[k] - y_cent));
-            if (radius <= state_radius[state]) {
-              field.energy0(x, y) = state_energy[state];
-              field.density0(x, y) = state_density[state];
+            if (radius <= s.radius) {
+              field.energy0(x, y) = s.energy;
+              field.density0(x, y) = s.density;
               for (int kt = k; kt <= k + 1; ++kt) {
                 for (int jt = j; jt <= j + 1; ++jt) {
-                  field.xvel0(jt, kt) = state_xvel[state];
-                  field.yvel0(jt, kt) = state_yvel[state];
+                  field.xvel0(jt, kt) = s.xvel;
+                  field.yvel0(jt, kt) = s.yvel;
                 }
               }
             }
-          } else if (state_geometry[state] == g_point) {
+          } else if (s.geometry == g_point) {
             if (field.vertexx[j] == x_cent && field.vertexy[k] == y_cent) {
-              field.energy0(x, y) = state_energy[state];
-              field.density0(x, y) = state_density[state];
+              field.energy0(x, y) = s.energy;
+              field.density0(x, y) = s.density;
               for (int kt = k; kt <= k + 1; ++kt) {
                 for (int jt = j; jt <= j + 1; ++jt) {
-                  field.xvel0(jt, kt) = state_xvel[state];
-                  field.yvel0(jt, kt) = state_yvel[state];
+                  field.xvel0(jt, kt) = s.xvel;
+                  field.yvel0(jt, kt) = s.yvel;
                 }
               }
             }
           }
         });
   }
-
-  state_density.release();
-  state_energy.release();
-  state_xvel.release();
-  state_yvel.release();
-  state_xmin.release();
-  state_xmax.release();
-  state_ymin.release();
-  state_ymax.release();
-  state_radius.release();
-  state_geometry.release();
 }
@@ -35,9 +35,28 @@ register_flag_optional(USE_ONEDPL
                    This requires the DPC++ compiler (other SYCL compilers are untested), required SYCL flags are added automatically."
         "OFF")
 
+register_flag_optional(USE_RANGE2D_MODE
+        "Set the iteration mode used for 2D kernels (par_ranged2), supported values are:
+           RANGE2D_LINEAR  - Linearise the 2D range to a 1D range using divisions and modulo for every cell
+           RANGE2D_BLOCKED - Each work item processes a contiguous x-run (of up to RANGE2D_BLOCK_X cells) of a single row
+         If unset, RANGE2D_LINEAR is used for the oneDPL DPCPP backend and RANGE2D_BLOCKED for everything else."
+        "")
+
+register_flag_optional(USE_RANGE2D_BLOCK_X
+        "Number of cells in x processed by each work item when RANGE2D_MODE is RANGE2D_BLOCKED"
+        "256")
+
 macro(setup)
     set(CMAKE_CXX_STANDARD 17) # because SYCL oneDPL is C++17, NVHPC isn't bound by this
 
+    if (USE_RANGE2D_MODE)
+        register_definitions(RANGE2D_MODE=${USE_RANGE2D_MODE})
+    endif ()
+
+    if (USE_RANGE2D_BLOCK_X)
+        register_definitions(RANGE2D_BLOCK_X=${USE_RANGE2D_BLOCK_X})
+    endif ()
+
     if (USE_TBB)
         register_link_library(TBB::tbb)
     endif ()
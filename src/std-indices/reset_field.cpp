@@ -19,8 +19,11 @@
 
 #include "reset_field.h"
 #include "context.h"
+#include "perf_counters.h"
 #include "timer.h"
 
+bool fused_summary_supported() { return false; }
+
 //  @brief Fortran reset field kernel.
 //  @author Wayne Gaudin
 //  @details Copies all of the final end of step filed data to the begining of
@@ -51,6 +54,7 @@ void reset_field(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::reset_field);
 
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
 
@@ -61,5 +65,6 @@ void reset_field(global_variables &globals) {
                        t.field.yvel1);
   }
 
+  clover::counters::end(clover::counters::reset_field);
   if (globals.profiler_on) globals.profiler.reset += timer() - kernel_time;
 }
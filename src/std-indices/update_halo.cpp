@@ -22,6 +22,7 @@
 #include "comms_kernel.h"
 #include "context.h"
 #include "timer.h"
+#include "trace.h"
 #include "update_tile_halo.h"
 
 //   @brief Fortran kernel to update the external halo cells in a chunk.
@@ -631,19 +632,24 @@ void update_halo(global_variables &globals, int fields[NUM_FIELDS], int depth) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::trace::begin("tile_halo_exchange");
   update_tile_halo(globals, fields, depth);
+  clover::trace::end();
   if (globals.profiler_on) {
     globals.profiler.tile_halo_exchange += timer() - kernel_time;
     kernel_time = timer();
   }
 
+  clover::trace::begin("mpi_halo_exchange");
   clover_exchange(globals, fields, depth);
+  clover::trace::end();
 
   if (globals.profiler_on) {
     globals.profiler.mpi_halo_exchange += timer() - kernel_time;
     kernel_time = timer();
   }
 
+  clover::trace::begin("self_halo_exchange");
   if ((globals.chunk.chunk_neighbours[chunk_left] == external_face) || (globals.chunk.chunk_neighbours[chunk_right] == external_face) ||
       (globals.chunk.chunk_neighbours[chunk_bottom] == external_face) || (globals.chunk.chunk_neighbours[chunk_top] == external_face)) {
 
@@ -653,6 +659,7 @@ void update_halo(global_variables &globals, int fields[NUM_FIELDS], int depth) {
                          t.field, fields, depth);
     }
   }
+  clover::trace::end();
 
   if (globals.profiler_on) globals.profiler.self_halo_exchange += timer() - kernel_time;
 }
@@ -20,6 +20,7 @@
 
 #include "accelerate.h"
 #include "context.h"
+#include "perf_counters.h"
 #include "timer.h"
 
 // @brief Fortran acceleration kernel
@@ -69,6 +70,7 @@ void accelerate(global_variables &globals) {
 
   double kernel_time = 0;
   if (globals.profiler_on) kernel_time = timer();
+  clover::counters::begin(clover::counters::accelerate);
 
   for (int tile = 0; tile < globals.config.tiles_per_chunk; ++tile) {
     tile_type &t = globals.chunk.tiles[tile];
@@ -89,5 +91,6 @@ void accelerate(global_variables &globals) {
     });
   }
 
+  clover::counters::end(clover::counters::accelerate);
   if (globals.profiler_on) globals.profiler.acceleration += timer() - kernel_time;
 }
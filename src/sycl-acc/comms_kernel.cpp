@@ -94,15 +94,15 @@ template <typename A> decltype(auto) get_native_ptr_or_throw(sycl::interop_handl
 void clover_send_recv_message(global_variables &globals, chunk_neighbour_type tpe, clover::Buffer1D<double> &snd_buffer,
                               clover::Buffer1D<double> &rcv_buffer, int total_size, int tag_send, int tag_recv, MPI_Request &req_send,
                               MPI_Request &req_recv) {
-  int task = globals.chunk.chunk_neighbours[tpe] - 1;
+  int task = globals.chunk.neighbour_task(tpe);
 #ifdef USE_HOSTTASK
   if (globals.config.staging_buffer) {
     globals.context.queue.submit([&](sycl::handler &h) {
       auto snd_buffer_acc = snd_buffer.buffer.get_host_access(h, sycl::read_only);
       auto rcv_buffer_acc = rcv_buffer.buffer.get_host_access(h, sycl::write_only);
       h.host_task([=, &req_send, &req_recv]() { // XXX pass handle arg here as copy, not ref!
-        MPI_Isend(snd_buffer_acc.get_pointer(), total_size, MPI_DOUBLE, task, tag_send, MPI_COMM_WORLD, &req_send);
-        MPI_Irecv(rcv_buffer_acc.get_pointer(), total_size, MPI_DOUBLE, task, tag_recv, MPI_COMM_WORLD, &req_recv);
+        MPI_Isend(snd_buffer_acc.get_pointer(), total_size, MPI_DOUBLE, task, tag_send, g_comm, &req_send);
+        MPI_Irecv(rcv_buffer_acc.get_pointer(), total_size, MPI_DOUBLE, task, tag_recv, g_comm, &req_recv);
       });
     });
   } else {
@@ -111,16 +111,16 @@ void clover_send_recv_message(global_variables &globals, chunk_neighbour_type tp
       auto rcv_buffer_acc = rcv_buffer.buffer.get_access<sycl::access_mode::write>(h);
 
       h.host_task([=, &req_send, &req_recv](sycl::interop_handle ih) { // XXX pass handle arg here as copy, not ref!
-        MPI_Isend(get_native_ptr_or_throw(ih, snd_buffer_acc), total_size, MPI_DOUBLE, task, tag_send, MPI_COMM_WORLD, &req_send);
-        MPI_Irecv(get_native_ptr_or_throw(ih, rcv_buffer_acc), total_size, MPI_DOUBLE, task, tag_recv, MPI_COMM_WORLD, &req_recv);
+        MPI_Isend(get_native_ptr_or_throw(ih, snd_buffer_acc), total_size, MPI_DOUBLE, task, tag_send, g_comm, &req_send);
+        MPI_Irecv(get_native_ptr_or_throw(ih, rcv_buffer_acc), total_size, MPI_DOUBLE, task, tag_recv, g_comm, &req_recv);
       });
     });
   }
 #else
   if (globals.config.staging_buffer) {
     globals.context.queue.wait_and_throw();
-    MPI_Isend(snd_buffer.access_ptr<R>(total_size), total_size, MPI_DOUBLE, task, tag_send, MPI_COMM_WORLD, &req_send);
-    MPI_Irecv(rcv_buffer.access_ptr<W>(total_size), total_size, MPI_DOUBLE, task, tag_recv, MPI_COMM_WORLD, &req_recv);
+    MPI_Isend(snd_buffer.access_ptr<R>(total_size), total_size, MPI_DOUBLE, task, tag_send, g_comm, &req_send);
+    MPI_Irecv(rcv_buffer.access_ptr<W>(total_size), total_size, MPI_DOUBLE, task, tag_recv, g_comm, &req_recv);
   } else {
   #if defined(__HIPSYCL__) || defined(__OPENSYCL__)
     auto d = globals.context.queue.get_device();
@@ -139,8 +139,8 @@ void clover_send_recv_message(global_variables &globals, chunk_neighbour_type tp
                            h.update(sycl::accessor{rcv_buffer.buffer, h, sycl::write_only});
                          })
         .wait_and_throw();
-    MPI_Isend(snd_buffer.buffer.get_pointer(d), total_size, MPI_DOUBLE, task, tag_send, MPI_COMM_WORLD, &req_send);
-    MPI_Irecv(rcv_buffer.buffer.get_pointer(d), total_size, MPI_DOUBLE, task, tag_recv, MPI_COMM_WORLD, &req_recv);
+    MPI_Isend(snd_buffer.buffer.get_pointer(d), total_size, MPI_DOUBLE, task, tag_send, g_comm, &req_send);
+    MPI_Irecv(rcv_buffer.buffer.get_pointer(d), total_size, MPI_DOUBLE, task, tag_recv, g_comm, &req_recv);
   #else
     throw std::logic_error("host_task is disabled and staging is also disabled, this won't work");
   #endif
@@ -171,6 +171,9 @@ void clover_wait_messages(global_variables &globals, int message_count, std::arr
 #endif
 }
 
+// Fields may live in device memory here, so only the pack path is implemented
+bool clover_exchange_supported(halo_exchange_type type) { return type == halo_exchange_type::pack; }
+
 void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], const int depth) {
 
   // Assuming 1 patch per task, this will be changed
@@ -197,15 +200,16 @@ void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], co
   //  globals.chunk.right_rcv_buffer.buffer.size()) << " BT = " <<  (globals.chunk.top_rcv_buffer.buffer.size() +
   //  globals.chunk.bottom_rcv_buffer.buffer.size()) << std::endl;
 
-  static clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
+  // Ranks may be threads of one process (see mpi_shim.h), so every thread keeps its own buffers
+  static thread_local clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
 
-  static clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
 
   if (globals.chunk.chunk_neighbours[chunk_left] != external_face) {
     // do left exchanges
@@ -0,0 +1,31 @@
+/*
+ Crown Copyright 2012 AWE.
+
+ This file is part of CloverLeaf.
+
+ CloverLeaf is free software: you can redistribute it and/or modify it under
+ the terms of the GNU General Public License as published by the
+ Free Software Foundation, either version 3 of the License, or (at your option)
+ any later version.
+
+ CloverLeaf is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ details.
+
+ You should have received a copy of the GNU General Public License along with
+ CloverLeaf. If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "field_view.h"
+
+// Fields are sycl::buffers here, which have no address outside of an accessor, so only the (row-major) layout is handed out
+clover::field_view clover_field_view(global_variables &globals, int tile, int field) {
+  auto *buffer = clover::field_buffer(globals.chunk.tiles[tile].field, field);
+  if (!buffer) return {nullptr, 0, 0, 0, 0, clover::field_view::memory::none};
+  size_t nx = buffer->extent<0>(), ny = buffer->extent<1>();
+  return {nullptr, nx, ny, static_cast<std::ptrdiff_t>(ny), 1, clover::field_view::memory::none};
+}
+
+// mirrored() reads through a host accessor, which waits for the kernels writing the buffer
+std::vector<double> clover_field_host(global_variables &, clover::Buffer2D<double> &buffer) { return buffer.mirrored(); }
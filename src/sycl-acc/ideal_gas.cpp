@@ -20,6 +20,8 @@
 #include "ideal_gas.h"
 #include "context.h"
 
+bool streaming_stores_supported() { return false; }
+
 #define IDX(buffer, x, y) buffer[idx[(x)]][idx[(y)]]
 
 #define SWP(x, y) (x), (y)
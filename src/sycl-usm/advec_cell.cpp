@@ -20,6 +20,8 @@
 #include "advec_cell.h"
 #include "context.h"
 
+bool advec_simd_supported() { return false; }
+
 //  @brief Fortran cell advection kernel.
 //  @author Wayne Gaudin
 //  @details Performs a second order advective remap using van-Leer limiting
@@ -71,7 +73,7 @@ void advec_cell_kernel(sycl::queue &queue, int x_min, int x_max, int y_min, int
         downwind = j;
         dif = donor;
       } else {
-        upwind = sycl::min(j + 1, x_max + 2);
+        upwind = sycl::min(j + 1, x_max + 3);
         donor = j;
         downwind = j - 1;
         dif = upwind;
@@ -160,7 +162,7 @@ void advec_cell_kernel(sycl::queue &queue, int x_min, int x_max, int y_min, int
         downwind = k;
         dif = donor;
       } else {
-        upwind = sycl::min(k + 1, y_max + 2);
+        upwind = sycl::min(k + 1, y_max + 3);
         donor = k;
         downwind = k - 1;
         dif = upwind;
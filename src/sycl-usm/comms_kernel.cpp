@@ -74,18 +74,21 @@ void clover_allocate_buffers(global_variables &globals, parallel_ &parallel) {
 void clover_send_recv_message(global_variables &globals, chunk_neighbour_type tpe, clover::Buffer1D<double> &snd_buffer,
                               clover::Buffer1D<double> &rcv_buffer, int total_size, int tag_send, int tag_recv, MPI_Request &req_send,
                               MPI_Request &req_recv) {
-  int task = globals.chunk.chunk_neighbours[tpe] - 1;
-  MPI_Isend(snd_buffer.data, total_size, MPI_DOUBLE, task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(rcv_buffer.data, total_size, MPI_DOUBLE, task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int task = globals.chunk.neighbour_task(tpe);
+  MPI_Isend(snd_buffer.data, total_size, MPI_DOUBLE, task, tag_send, g_comm, &req_send);
+  MPI_Irecv(rcv_buffer.data, total_size, MPI_DOUBLE, task, tag_recv, g_comm, &req_recv);
 }
 
 void clover_send_recv_message(global_variables &globals, chunk_neighbour_type tpe, double *snd_buffer, double *rcv_buffer, int total_size,
                               int tag_send, int tag_recv, MPI_Request &req_send, MPI_Request &req_recv) {
-  int task = globals.chunk.chunk_neighbours[tpe] - 1;
-  MPI_Isend(snd_buffer, total_size, MPI_DOUBLE, task, tag_send, MPI_COMM_WORLD, &req_send);
-  MPI_Irecv(rcv_buffer, total_size, MPI_DOUBLE, task, tag_recv, MPI_COMM_WORLD, &req_recv);
+  int task = globals.chunk.neighbour_task(tpe);
+  MPI_Isend(snd_buffer, total_size, MPI_DOUBLE, task, tag_send, g_comm, &req_send);
+  MPI_Irecv(rcv_buffer, total_size, MPI_DOUBLE, task, tag_recv, g_comm, &req_recv);
 }
 
+// Fields may live in device memory here, so only the pack path is implemented
+bool clover_exchange_supported(halo_exchange_type type) { return type == halo_exchange_type::pack; }
+
 void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], const int depth) {
 
   // Assuming 1 patch per task, this will be changed
@@ -107,15 +110,16 @@ void clover_exchange(global_variables &globals, const int fields[NUM_FIELDS], co
     }
   }
 
-  static clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
-  static clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
+  // Ranks may be threads of one process (see mpi_shim.h), so every thread keeps its own buffers
+  static thread_local clover::Buffer1D<double> left_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> left_snd_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_rcv_buffer(globals.context, end_pack_index_left_right);
+  static thread_local clover::Buffer1D<double> right_snd_buffer(globals.context, end_pack_index_left_right);
 
-  static clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
-  static clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> top_snd_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_rcv_buffer(globals.context, end_pack_index_bottom_top);
+  static thread_local clover::Buffer1D<double> bottom_snd_buffer(globals.context, end_pack_index_bottom_top);
 
   double *h_left_rcv_buffer, *h_left_snd_buffer;
   double *h_right_rcv_buffer, *h_right_snd_buffer;
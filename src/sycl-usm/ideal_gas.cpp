@@ -21,6 +21,8 @@
 #include "context.h"
 #include <cmath>
 
+bool streaming_stores_supported() { return false; }
+
 #define IDX(buffer, x, y) buffer[idx[(x)]][idx[(y)]]
 
 #define SWP(x, y) (x), (y)